@@ -0,0 +1,1199 @@
+//数学・衝突判定の基本関数のマイクロベンチマーク
+//使い方: MT2Benchmark [--format=text|csv|json] [--output=path] [--seed=N] [--min-time-ms=N] [--trace=path]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BVH.h"
+#include "Camera.h"
+#include "Collision.h"
+#include "DebugLines.h"
+#include "FrameArena.h"
+#include "Frustum.h"
+#include "LineClip.h"
+#include "LineSinks.h"
+#include "MathFunction.h"
+#include "Profiler.h"
+#include "QuatOBB.h"
+#include "OBBSet.h"
+#include "StructuredMatrix.h"
+#include "SceneFile.h"
+#include "SegmentQueryScheduler.h"
+#include "Simd.h"
+#include "SpatialHashGrid.h"
+#include "SweepAndPrune.h"
+#include "SweptCollision.h"
+#include "ThreadPool.h"
+
+namespace {
+
+//1項目分の計測結果
+struct BenchmarkRecord {
+	std::string name;
+	size_t batchSize;
+	uint64_t operations;
+	double nsPerOp;
+	double opsPerSec;
+};
+
+//計測の設定
+struct BenchmarkConfig {
+	uint32_t seed = 12345;
+	double minTimeMs = 50.0;
+	std::string format = "text";
+	std::string output;
+	std::string trace;//空でなければ項目ごとの区間をChromeのトレース形式で書き出す
+};
+
+//ベンチマーク用の入力(乱数の種を固定して毎回同じものを作る)
+struct BenchmarkInput {
+	std::vector<Matrix4x4> matrices;
+	std::vector<Matrix4x4> rigidMatrices;
+	std::vector<Vector3> vectors;
+	std::vector<Vector3> rotates;
+	std::vector<float> angles;
+	std::vector<AABB> aabbs;
+	std::vector<Segment> segments;
+	std::vector<OBB> obbs;
+	SegmentSoA segmentSoA;
+	OBBSoA obbSoA;
+};
+
+BenchmarkInput MakeInput(size_t count, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> size(0.1f, 2.0f);
+
+	BenchmarkInput input;
+	for (size_t i = 0; i < count; ++i) {
+		Vector3 rotate{ angle(random),angle(random),angle(random) };
+		Vector3 translate{ position(random),position(random),position(random) };
+		Matrix4x4 rigid = MakeAffineMatrix({ 1.0f,1.0f,1.0f }, rotate, translate);
+		input.rigidMatrices.push_back(rigid);
+		input.matrices.push_back(MakeAffineMatrix({ size(random),size(random),size(random) }, rotate, translate));
+		input.vectors.push_back({ position(random),position(random),position(random) });
+		input.rotates.push_back(rotate);
+		input.angles.push_back(angle(random));
+
+		Vector3 center{ position(random),position(random),position(random) };
+		Vector3 extent{ size(random),size(random),size(random) };
+		input.aabbs.push_back({ Subtract(center, extent),Add(center, extent) });
+
+		Segment segment{ { position(random),position(random),position(random) },{ position(random),position(random),position(random) } };
+		input.segments.push_back(segment);
+		input.segmentSoA.PushBack(segment);
+
+		OBB obb;
+		obb.center = translate;
+		for (int axis = 0; axis < 3; ++axis) {
+			obb.orientations[axis] = { rigid.m[axis][0],rigid.m[axis][1],rigid.m[axis][2] };
+		}
+		obb.size = extent;
+		input.obbs.push_back(obb);
+		input.obbSoA.PushBack(obb);
+	}
+	return input;
+}
+
+//回転行列を3つ作って掛け合わせる以前のMakeAffineMatrix(比較用)
+Matrix4x4 MakeAffineMatrixReference(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
+	Matrix4x4 rotateXYZMatrix = MatrixMultiply(MakeRotateXMatrix(rotate.x), MatrixMultiply(MakeRotateYMatrix(rotate.y), MakeRotateZMatrix(rotate.z)));
+	Matrix4x4 result = rotateXYZMatrix;
+	for (int column = 0; column < 3; ++column) {
+		result.m[0][column] *= scale.x;
+		result.m[1][column] *= scale.y;
+		result.m[2][column] *= scale.z;
+	}
+	result.m[3][0] = translate.x;
+	result.m[3][1] = translate.y;
+	result.m[3][2] = translate.z;
+	return result;
+}
+
+//展開したMakeAffineMatrixが以前の結果と誤差の範囲で一致するか調べ、最大誤差を返す
+float VerifyMakeAffineMatrix(uint32_t seed) {
+	const BenchmarkInput input = MakeInput(4096, seed);
+	float maxError = 0.0f;
+	for (size_t i = 0; i < input.rotates.size(); ++i) {
+		Matrix4x4 fused = MakeAffineMatrix(input.vectors[i], input.rotates[i], input.vectors[i]);
+		Matrix4x4 reference = MakeAffineMatrixReference(input.vectors[i], input.rotates[i], input.vectors[i]);
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				float error = std::fabs(fused.m[row][column] - reference.m[row][column]);
+				//スケールが大きい要素は相対誤差で見る
+				float magnitude = std::fabs(reference.m[row][column]);
+				maxError = std::max(maxError, magnitude > 1.0f ? error / magnitude : error);
+			}
+		}
+	}
+	return maxError;
+}
+
+//まとめて作った3x4の行列が1つずつ作ったMakeAffineMatrixと一致するか調べ、最大誤差を返す
+float VerifyMakeAffineMatrices(uint32_t seed) {
+	const BenchmarkInput input = MakeInput(4096, seed);
+	std::vector<AffineMatrix3x4> batched(input.rotates.size());
+	MakeAffineMatrices(input.vectors, input.rotates, input.vectors, batched);
+	float maxError = 0.0f;
+	for (size_t i = 0; i < batched.size(); ++i) {
+		Matrix4x4 reference = MakeAffineMatrix(input.vectors[i], input.rotates[i], input.vectors[i]);
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 3; ++column) {
+				float error = std::fabs(batched[i].m[row][column] - reference.m[row][column]);
+				float magnitude = std::fabs(reference.m[row][column]);
+				maxError = std::max(maxError, magnitude > 1.0f ? error / magnitude : error);
+			}
+		}
+	}
+	return maxError;
+}
+
+//コンパイル時に作った行列と実行時に作った行列の最大誤差を返す
+float VerifyConstexprMatrices() {
+	constexpr Matrix4x4 kProjectionMatrix = MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+	constexpr Matrix4x4 kAffineMatrix = MakeAffineMatrix({ 1.0f,2.0f,3.0f }, { 0.26f,-7.0f,100.0f }, { 4.0f,5.0f,6.0f });
+	constexpr Matrix4x4 kScreenMatrix = MatrixMultiply(kProjectionMatrix, MakeViewportTransform(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f));
+	//volatileを通して実行時に計算させる
+	volatile float fovY = 0.45f;
+	volatile float rotateY = -7.0f;
+	volatile float width = 1280.0f;
+	const Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(fovY, 16.0f / 9.0f, 0.1f, 100.0f);
+	const Matrix4x4 pairs[3][2] = {
+		{ kProjectionMatrix,projectionMatrix },
+		{ kAffineMatrix,MakeAffineMatrix({ 1.0f,2.0f,3.0f }, { 0.26f,rotateY,100.0f }, { 4.0f,5.0f,6.0f }) },
+		{ kScreenMatrix,MatrixMultiply(projectionMatrix, MakeViewportMatrix(0.0f, 0.0f, width, 720.0f, 0.0f, 1.0f)) },
+	};
+	float maxError = 0.0f;
+	for (const auto& pair : pairs) {
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				float error = std::fabs(pair[0].m[row][column] - pair[1].m[row][column]);
+				float magnitude = std::fabs(pair[1].m[row][column]);
+				maxError = std::max(maxError, magnitude > 1.0f ? error / magnitude : error);
+			}
+		}
+	}
+	return maxError;
+}
+
+//最適化で計算が消えないように結果を書き込む先
+volatile float gSink = 0.0f;
+
+//bodyは1回の呼び出しでbatchSize個の処理を行い、結果の合計を返す
+template<class Body>
+BenchmarkRecord MeasureLoop(const BenchmarkConfig& config, const char* name, size_t batchSize, Body&& body) {
+	//一度回してキャッシュや分岐予測を温めておく
+	gSink = gSink + body();
+
+	uint64_t passes = 0;
+	double elapsedNs = 0.0;
+	auto start = std::chrono::steady_clock::now();
+	while (elapsedNs < config.minTimeMs * 1.0e6) {
+		gSink = gSink + body();
+		++passes;
+		elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	BenchmarkRecord record;
+	record.name = name;
+	record.batchSize = batchSize;
+	record.operations = passes * batchSize;
+	record.nsPerOp = elapsedNs / double(record.operations);
+	record.opsPerSec = 1.0e9 / record.nsPerOp;
+	return record;
+}
+
+template<class Body>
+BenchmarkRecord Measure(const BenchmarkConfig& config, const char* name, size_t batchSize, Body&& body) {
+	if (config.trace.empty()) {
+		return MeasureLoop(config, name, batchSize, body);
+	}
+	//トレースを取るときは1項目を1フレームとして記録する
+	Profiler& profiler = Profiler::Get();
+	BenchmarkRecord record;
+	profiler.BeginFrame();
+	{
+		ProfileScope scope(profiler.InternName(name));
+		record = MeasureLoop(config, name, batchSize, body);
+	}
+	profiler.EndFrame();
+	return record;
+}
+
+void RunBatch(const BenchmarkConfig& config, size_t batchSize, std::vector<BenchmarkRecord>& records) {
+	const BenchmarkInput input = MakeInput(batchSize, config.seed);
+	const size_t n = batchSize;
+
+	records.push_back(Measure(config, "MatrixMultiply", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MatrixMultiply(input.matrices[i], input.rigidMatrices[i]).m[3][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "Inverse", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += Inverse(input.matrices[i]).m[3][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "InverseAffine", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += InverseAffine(input.matrices[i]).m[3][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "InverseRigid", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += InverseRigid(input.rigidMatrices[i]).m[3][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "Transform", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += Transform(input.vectors[i], input.matrices[i]).x;
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "TransformPoint", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += TransformPoint(input.vectors[i], input.matrices[i]).x;
+		}
+		return sum;
+		}));
+	std::vector<Vector3> transformed(n);
+	records.push_back(Measure(config, "TransformPoints", n, [&]() {
+		TransformPoints(input.vectors, transformed, input.matrices[0]);
+		return transformed[n - 1].x;
+		}));
+	records.push_back(Measure(config, "MakeAffineMatrix", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MakeAffineMatrix(input.vectors[i], input.rotates[i], input.vectors[i]).m[0][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MakeAffineMatrix/reference", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MakeAffineMatrixReference(input.vectors[i], input.rotates[i], input.vectors[i]).m[0][0];
+		}
+		return sum;
+		}));
+	std::vector<AffineMatrix3x4> affineMatrices(n);
+	records.push_back(Measure(config, "MakeAffineMatrices", n, [&]() {
+		MakeAffineMatrices(input.vectors, input.rotates, input.vectors, affineMatrices);
+		return affineMatrices[n - 1].m[0][0];
+		}));
+	records.push_back(Measure(config, "MakeRotateXYZMatrix", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MakeRotateXYZMatrix(input.rotates[i]).m[0][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MakeRotateXMatrix", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MakeRotateXMatrix(input.angles[i]).m[1][1];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MakeRotateYMatrix", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MakeRotateYMatrix(input.angles[i]).m[0][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MakeRotateZMatrix", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MakeRotateZMatrix(input.angles[i]).m[0][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "AabbSegmentIsCollision", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += AabbSegmentIsCollision(input.aabbs[i], input.segments[i]) ? 1.0f : 0.0f;
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "ObbSegmentIsCollision", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += ObbSegmentIsCollision(input.segments[i], input.obbs[i]) ? 1.0f : 0.0f;
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "ObbSegmentIntersect", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			SegmentHit hit;
+			sum += ObbSegmentIntersect(input.segments[i], input.obbs[i], hit) ? hit.point.x : 0.0f;
+		}
+		return sum;
+		}));
+
+	//逆行列を前計算した場合のboolと交差結果の差
+	std::vector<Matrix4x4> obbInverses(n);
+	for (size_t i = 0; i < n; ++i) {
+		obbInverses[i] = InverseRigid(MakeOBBWorldMatrix(input.obbs[i]));
+	}
+	records.push_back(Measure(config, "ObbSegmentIntersectLocal/bool", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			float tmin;
+			sum += ObbSegmentIntersectLocal(input.segments[i], input.obbs[i], obbInverses[i], tmin) ? tmin : 0.0f;
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "ObbSegmentIntersectLocal/hit", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			SegmentHit hit;
+			sum += ObbSegmentIntersectLocal(input.segments[i], input.obbs[i], obbInverses[i], hit) ? hit.tEnter : 0.0f;
+		}
+		return sum;
+		}));
+
+	//1つのAABBとn本の線分(SIMDの段階ごと)
+	SegmentSlabSoA slab;
+	slab.Build(input.segmentSoA.View());
+	std::vector<uint8_t> hits(n);
+	std::vector<float> tEnters(n);
+	const char* slabNames[] = { "AabbSegmentIsCollisionBatch/scalar","AabbSegmentIsCollisionBatch/sse","AabbSegmentIsCollisionBatch/avx2" };
+	for (int level = 0; level <= int(GetSimdLevel()); ++level) {
+		records.push_back(Measure(config, slabNames[level], n, [&]() {
+			AabbSegmentIsCollisionBatch(input.aabbs[0], slab, hits.data(), tEnters.data(), SimdLevel(level));
+			return tEnters[n - 1];
+			}));
+	}
+
+	//総当たりは組み合わせが多いのでOBBの数を抑える
+	const size_t kBatchObbCount = 16;
+	size_t obbCount = n < kBatchObbCount ? n : kBatchObbCount;
+	OBBSoAView obbView = input.obbSoA.View();
+	obbView.count = obbCount;
+	std::vector<uint8_t> hitMasks(n * obbCount);
+	std::vector<float> pairTEnters(n * obbCount);
+	//作業領域は1フレーム分の一時バッファから取る
+	FrameArena batchArena(4096);
+	records.push_back(Measure(config, "ObbSegmentIsCollisionBatch", n * obbCount, [&]() {
+		ObbSegmentIsCollisionBatch(input.segmentSoA.View(), obbView, hitMasks.data(), pairTEnters.data(), batchArena);
+		batchArena.EndFrame();
+		return pairTEnters[0];
+		}));
+
+	//視錐台カリング(入力の範囲の一部が映るカメラ)
+	Camera camera;
+	camera.translate = { 0.0f,0.0f,-15.0f };
+	camera.Update();
+	const Frustum frustum = MakeFrustum(camera.GetViewProjectionMatrix());
+	records.push_back(Measure(config, "IsOBBVisible", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += IsOBBVisible(frustum, input.obbs[i]) ? 1.0f : 0.0f;
+		}
+		return sum;
+		}));
+	std::vector<uint8_t> visible(n);
+	records.push_back(Measure(config, "CullOBBs", n, [&]() {
+		return float(CullOBBs(frustum, input.obbSoA.View(), visible.data()));
+		}));
+	records.push_back(Measure(config, "ProjectLine", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			Vector3 screenStart;
+			Vector3 screenEnd;
+			if (ProjectLine(input.segments[i].origin, Add(input.segments[i].origin, input.segments[i].diff), camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), screenStart, screenEnd)) {
+				sum += screenStart.x;
+			}
+		}
+		return sum;
+		}));
+
+	//隣り合う番号のOBBの組(ほとんどは離れているので早期終了の速さになる)
+	std::vector<ObbPair> obbPairs(n);
+	for (size_t i = 0; i < n; ++i) {
+		obbPairs[i] = { uint32_t(i),uint32_t((i + 1) % n) };
+	}
+	std::vector<uint8_t> pairHits(n);
+	std::vector<ObbContact> contacts(n);
+	records.push_back(Measure(config, "ObbObbIsCollisionBatch", n, [&]() {
+		ObbObbIsCollisionBatch(input.obbSoA.View(), obbPairs.data(), n, pairHits.data(), nullptr);
+		return float(pairHits[n - 1]);
+		}));
+	records.push_back(Measure(config, "ObbObbIsCollisionBatch/contact", n, [&]() {
+		ObbObbIsCollisionBatch(input.obbSoA.View(), obbPairs.data(), n, pairHits.data(), contacts.data());
+		return contacts[n - 1].depth;
+		}));
+}
+
+//スレッド数ごとのスケジューラの計測(結果が1スレッドの時と一致するかも調べる)
+//スレッド数はハードウェアのスレッド数によらず1/2/4/8/16を回す(コアが足りなければ伸びないのはそのまま見える)
+bool RunScheduler(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const size_t kSegmentCount = 65536;
+	const size_t kObbCount = 1024;
+	const BenchmarkInput input = MakeInput(kSegmentCount, config.seed);
+	OBBSoAView obbView = input.obbSoA.View();
+	obbView.count = kObbCount;
+	OBBBVH bvh;
+	bvh.Build(obbView);
+	const SegmentSoAView segmentView = input.segmentSoA.View();
+
+	std::vector<SegmentObbHit> reference;
+	std::vector<ObbPairHit> pairReference;
+	{
+		ThreadPool pool(1);
+		SegmentQueryScheduler scheduler(pool);
+		scheduler.Query(segmentView, bvh, reference);
+		scheduler.QueryOverlaps(obbView, bvh, pairReference);
+	}
+
+	std::fprintf(stderr, "SegmentQueryScheduler scaling (%u hardware threads):\n", std::max(1u, std::thread::hardware_concurrency()));
+	const uint32_t kThreadCounts[] = { 1,2,4,8,16 };
+	double singleThreadNs = 0.0;
+	for (uint32_t threads : kThreadCounts) {
+		ThreadPool pool(threads);
+		SegmentQueryScheduler scheduler(pool);
+		std::vector<SegmentObbHit> hits;
+
+		//BVHと総当たりのどちらも1スレッドのBVHと同じ結果になるはず
+		std::vector<SegmentObbHit> bruteForce;
+		scheduler.Query(segmentView, bvh, hits);
+		scheduler.Query(segmentView, obbView, bruteForce);
+		for (const std::vector<SegmentObbHit>* result : { &hits,&bruteForce }) {
+			bool same = result->size() == reference.size();
+			for (size_t i = 0; same && i < reference.size(); ++i) {
+				same = (*result)[i].segmentIndex == reference[i].segmentIndex && (*result)[i].obbIndex == reference[i].obbIndex && (*result)[i].t == reference[i].t;
+			}
+			if (!same) {
+				std::fprintf(stderr, "SegmentQueryScheduler result differs with %u threads\n", threads);
+				return false;
+			}
+		}
+		std::vector<ObbPairHit> pairHits;
+		scheduler.QueryOverlaps(obbView, bvh, pairHits);
+		bool isPairSame = pairHits.size() == pairReference.size();
+		for (size_t i = 0; isPairSame && i < pairReference.size(); ++i) {
+			isPairSame = pairHits[i].a == pairReference[i].a && pairHits[i].b == pairReference[i].b &&
+				std::memcmp(&pairHits[i].contact, &pairReference[i].contact, sizeof(ObbContact)) == 0;
+		}
+		if (!isPairSame) {
+			std::fprintf(stderr, "SegmentQueryScheduler overlaps differ with %u threads\n", threads);
+			return false;
+		}
+
+		std::string bvhName = "SegmentQueryScheduler/bvh/threads" + std::to_string(threads);
+		records.push_back(Measure(config, bvhName.c_str(), kSegmentCount, [&]() {
+			scheduler.Query(segmentView, bvh, hits);
+			return float(hits.size());
+			}));
+		if (threads == 1) {
+			singleThreadNs = records.back().nsPerOp;
+		}
+		std::fprintf(stderr, "  %2u threads: bvh %.1f ns/segment, %.2fx of 1 thread\n", threads, records.back().nsPerOp,
+			singleThreadNs / records.back().nsPerOp);
+		std::string bruteName = "SegmentQueryScheduler/brute/threads" + std::to_string(threads);
+		records.push_back(Measure(config, bruteName.c_str(), kSegmentCount, [&]() {
+			scheduler.Query(segmentView, obbView, hits);
+			return float(hits.size());
+			}));
+		std::string overlapName = "SegmentQueryScheduler/overlaps/threads" + std::to_string(threads);
+		records.push_back(Measure(config, overlapName.c_str(), kObbCount, [&]() {
+			scheduler.QueryOverlaps(obbView, bvh, pairHits);
+			return float(pairHits.size());
+			}));
+	}
+	return true;
+}
+
+//少しずつ動くOBBに対するsweep and prune(挿入ソートでの更新と一から並べ直す場合の比較)
+//更新した組を分離軸判定に渡した結果が総当たりと一致するかも調べる
+bool RunSweepAndPrune(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const size_t kObbCount = 4096;
+	const BenchmarkInput input = MakeInput(kObbCount, config.seed);
+
+	//2つの姿勢を交互に与えて、フレームごとに少し動く状態を作る
+	//入力のままだと密集して掃引の方が支配的になるので広げておく
+	OBBSoA frames[2];
+	for (size_t i = 0; i < kObbCount; ++i) {
+		OBB obb = input.obbs[i];
+		obb.center = Multiply(8.0f, obb.center);
+		frames[0].PushBack(obb);
+		obb.center = Add(obb.center, Multiply(0.02f, input.vectors[i]));
+		frames[1].PushBack(obb);
+	}
+	const OBBSoAView views[2] = { frames[0].View(),frames[1].View() };
+
+	SweepAndPrune sweepAndPrune;
+	sweepAndPrune.Build(views[0]);
+	ThreadPool pool;
+	SegmentQueryScheduler scheduler(pool);
+	std::vector<ObbPairHit> pairHits;
+
+	//何度か更新した後の組と当たりを総当たりと比べる
+	for (size_t frame = 1; frame <= 3; ++frame) {
+		const OBBSoAView& view = views[frame & 1];
+		sweepAndPrune.Update(view);
+		scheduler.QueryOverlaps(view, sweepAndPrune.GetPairs(), pairHits);
+		std::vector<ObbPair> pairs = sweepAndPrune.GetPairs();
+		std::vector<ObbPair> hitPairs;
+		for (const ObbPairHit& hit : pairHits) {
+			hitPairs.push_back({ hit.a,hit.b });
+		}
+		auto pairLess = [](const ObbPair& a, const ObbPair& b) { return a.a != b.a ? a.a < b.a : a.b < b.b; };
+		std::sort(pairs.begin(), pairs.end(), pairLess);
+		std::sort(hitPairs.begin(), hitPairs.end(), pairLess);
+
+		std::vector<OBB> obbs(kObbCount);
+		std::vector<AABB> bounds(kObbCount);
+		for (size_t i = 0; i < kObbCount; ++i) {
+			obbs[i] = GetOBB(view, i);
+			bounds[i] = MakeOBBWorldAABB(obbs[i]);
+		}
+		size_t pairIndex = 0;
+		size_t hitIndex = 0;
+		bool same = true;
+		for (uint32_t a = 0; same && a < kObbCount; ++a) {
+			for (uint32_t b = a + 1; same && b < kObbCount; ++b) {
+				if (bounds[a].min.x > bounds[b].max.x || bounds[b].min.x > bounds[a].max.x || bounds[a].min.y > bounds[b].max.y ||
+					bounds[b].min.y > bounds[a].max.y || bounds[a].min.z > bounds[b].max.z || bounds[b].min.z > bounds[a].max.z) {
+					continue;
+				}
+				same = pairIndex < pairs.size() && pairs[pairIndex].a == a && pairs[pairIndex].b == b;
+				++pairIndex;
+				if (same && ObbObbIsCollision(obbs[a], obbs[b])) {
+					same = hitIndex < hitPairs.size() && hitPairs[hitIndex].a == a && hitPairs[hitIndex].b == b;
+					++hitIndex;
+				}
+			}
+		}
+		if (!same || pairIndex != pairs.size() || hitIndex != hitPairs.size()) {
+			std::fprintf(stderr, "SweepAndPrune pairs differ from brute force after %zu updates\n", frame);
+			return false;
+		}
+	}
+
+	size_t frame = 0;
+	records.push_back(Measure(config, "SweepAndPrune/update", kObbCount, [&]() {
+		sweepAndPrune.Update(views[++frame & 1]);
+		return float(sweepAndPrune.GetPairs().size());
+		}));
+	records.push_back(Measure(config, "SweepAndPrune/update+sat", kObbCount, [&]() {
+		sweepAndPrune.Update(views[++frame & 1]);
+		scheduler.QueryOverlaps(views[frame & 1], sweepAndPrune.GetPairs(), pairHits);
+		return float(pairHits.size());
+		}));
+	records.push_back(Measure(config, "SweepAndPrune/build", kObbCount, [&]() {
+		sweepAndPrune.Build(views[++frame & 1]);
+		return float(sweepAndPrune.GetPairs().size());
+		}));
+	return true;
+}
+
+//小さなOBBが一様に散らばる場面でのハッシュグリッドとBVHの比較
+void RunSpatialHashGrid(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const size_t kObbCount = 16384;
+	const size_t kSegmentCount = 4096;
+	const BenchmarkInput input = MakeInput(kObbCount, config.seed);
+	OBBSoA obbs;
+	for (size_t i = 0; i < kObbCount; ++i) {
+		OBB obb = input.obbs[i];
+		obb.center = Multiply(2.0f, obb.center);
+		obb.size = Multiply(0.2f, obb.size);
+		obbs.PushBack(obb);
+	}
+	const OBBSoAView obbView = obbs.View();
+
+	OBBBVH bvh;
+	SpatialHashGrid grid(1.0f);
+	records.push_back(Measure(config, "OBBBVH::Build/small", kObbCount, [&]() {
+		bvh.Build(obbView);
+		return float(bvh.GetNodes().size());
+		}));
+	records.push_back(Measure(config, "SpatialHashGrid::Build/small", kObbCount, [&]() {
+		grid.Build(obbView);
+		return float(grid.GetCellCount());
+		}));
+
+	std::vector<uint32_t> hitIndices;
+	std::vector<float> hitTs;
+	records.push_back(Measure(config, "OBBBVH::QuerySegment/small", kSegmentCount, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < kSegmentCount; ++i) {
+			bvh.QuerySegment(input.segments[i], hitIndices, hitTs);
+			sum += float(hitIndices.size());
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "SpatialHashGrid::QuerySegment/small", kSegmentCount, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < kSegmentCount; ++i) {
+			grid.QuerySegment(input.segments[i], hitIndices, hitTs);
+			sum += float(hitIndices.size());
+		}
+		return sum;
+		}));
+}
+
+//隣り合う立方体を並べた場面での線の記録(1本ずつ渡す場合と、重複をまとめて1回で渡す場合の比較)
+void RunLineBatch(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const int kCubesPerSide = 32;
+	const size_t kCubeCount = size_t(kCubesPerSide) * kCubesPerSide;
+	Camera camera;
+	camera.translate = { 0.0f,20.0f,-30.0f };
+	camera.rotate = { 0.6f,0.0f,0.0f };
+	camera.Update();
+	std::vector<OBB> cubes;
+	for (int z = 0; z < kCubesPerSide; ++z) {
+		for (int x = 0; x < kCubesPerSide; ++x) {
+			OBB cube{};
+			cube.center = { float(x - kCubesPerSide / 2),0.0f,float(z) };
+			cube.orientations[0] = { 1.0f,0.0f,0.0f };
+			cube.orientations[1] = { 0.0f,1.0f,0.0f };
+			cube.orientations[2] = { 0.0f,0.0f,1.0f };
+			cube.size = { 0.5f,0.5f,0.5f };
+			cubes.push_back(cube);
+		}
+	}
+
+	CountingLineSink sink;
+	LineBatch perEdge;
+	perEdge.SetDeduplicate(false);
+	records.push_back(Measure(config, "LineBatch/per-edge-submit", kCubeCount, [&]() {
+		//1本ごとに描画先を呼ぶ(DrawLineを辺ごとに呼んでいた場合に相当)
+		for (const OBB& cube : cubes) {
+			AddOBBLines(perEdge, cube, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), 0xFFFFFFFF);
+			for (size_t line = 0; line < perEdge.GetLineCount(); ++line) {
+				sink.Submit(perEdge.GetVertices().subspan(line * 2, 2), perEdge.GetColors().subspan(line, 1));
+			}
+			perEdge.Clear();
+		}
+		return float(sink.GetLineCount());
+		}));
+
+	LineBatch batch;
+	records.push_back(Measure(config, "LineBatch/deduplicated-flush", kCubeCount, [&]() {
+		for (const OBB& cube : cubes) {
+			AddOBBLines(batch, cube, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), 0xFFFFFFFF);
+		}
+		batch.Flush(sink);
+		return float(sink.GetLineCount());
+		}));
+
+	//まとめた後の線をメモリ上の画像に描く
+	RasterLineSink raster(1280, 720);
+	records.push_back(Measure(config, "LineBatch/raster", kCubeCount, [&]() {
+		for (const OBB& cube : cubes) {
+			AddOBBLines(batch, cube, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), 0xFFFFFFFF);
+		}
+		batch.Flush(raster);
+		return float(raster.GetPixel(640, 360));
+		}));
+}
+
+//形の決まった行列の積(Matrix4x4同士の64回の掛け算との比較)
+void RunStructuredMatrix(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const size_t n = 4096;
+	const BenchmarkInput input = MakeInput(n, config.seed);
+	std::vector<AffineMatrix3x4> affineMatrices(n);
+	std::vector<RotationMatrix> rotationMatrices(n);
+	std::vector<Matrix4x4> rotationMatrices4x4(n);
+	for (size_t i = 0; i < n; ++i) {
+		affineMatrices[i] = ToAffineMatrix3x4(input.matrices[i]);
+		rotationMatrices[i] = MakeRotationMatrix(input.rotates[i]);
+		rotationMatrices4x4[i] = ToMatrix4x4(rotationMatrices[i]);
+	}
+	Camera camera;
+	camera.Update();
+	const Matrix4x4 viewProjectionMatrix = camera.GetViewProjectionMatrix();
+	const ViewportMatrix viewport = MakeViewportTransform(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f);
+	const Matrix4x4 viewportMatrix = ToMatrix4x4(viewport);
+
+	records.push_back(Measure(config, "MatrixMultiply/world*viewProjection", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MatrixMultiply(input.matrices[i], viewProjectionMatrix).m[3][3];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MatrixMultiply/affine*viewProjection", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MatrixMultiply(affineMatrices[i], viewProjectionMatrix).m[3][3];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MatrixMultiply/matrix*viewport", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MatrixMultiply(input.matrices[i], viewportMatrix).m[3][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MatrixMultiply/matrix*ViewportMatrix", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MatrixMultiply(input.matrices[i], viewport).m[3][0];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MatrixMultiply/rotate*rotate", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MatrixMultiply(rotationMatrices4x4[i], rotationMatrices4x4[n - 1 - i]).m[2][2];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MatrixMultiply/RotationMatrix", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MatrixMultiply(rotationMatrices[i], rotationMatrices[n - 1 - i]).m[2][2];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MatrixMultiply/scale*rotate", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MatrixMultiply(ToMatrix4x4(MakeScaleMatrix(input.vectors[i])), rotationMatrices4x4[i]).m[2][2];
+		}
+		return sum;
+		}));
+	records.push_back(Measure(config, "MatrixMultiply/ScaleMatrix*RotationMatrix", n, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < n; ++i) {
+			sum += MatrixMultiply(MakeScaleMatrix(input.vectors[i]), rotationMatrices[i]).m[2][2];
+		}
+		return sum;
+		}));
+}
+
+//OBBSetのハンドル経由の追加・削除と、ビューを渡した判定(std::vectorのOBBSoAとの比較)
+void RunOBBSet(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const size_t kObbCount = 65536;
+	const size_t kChurnCount = 1024;
+	const BenchmarkInput input = MakeInput(kObbCount, config.seed);
+	OBBSet obbSet;
+	obbSet.Reserve(kObbCount + kChurnCount);
+	std::vector<OBBHandle> handles(kObbCount);
+	for (size_t i = 0; i < kObbCount; ++i) {
+		handles[i] = obbSet.Add(input.obbs[i], { uint32_t(i),0 });
+	}
+
+	Camera camera;
+	camera.translate = { 0.0f,0.0f,-15.0f };
+	camera.Update();
+	const Frustum frustum = MakeFrustum(camera.GetViewProjectionMatrix());
+	std::vector<uint8_t> visible(kObbCount);
+	records.push_back(Measure(config, "CullOBBs/OBBSoA", kObbCount, [&]() {
+		return float(CullOBBs(frustum, input.obbSoA.View(), visible.data()));
+		}));
+	records.push_back(Measure(config, "CullOBBs/OBBSet", kObbCount, [&]() {
+		return float(CullOBBs(frustum, obbSet.View(), visible.data()));
+		}));
+
+	//毎回同じ数だけ消して足すので、要素数と容量は変わらない
+	std::mt19937 random(config.seed);
+	records.push_back(Measure(config, "OBBSet/Remove+Add", kChurnCount, [&]() {
+		for (size_t i = 0; i < kChurnCount; ++i) {
+			size_t index = random() % kObbCount;
+			obbSet.Remove(handles[index]);
+			handles[index] = obbSet.Add(input.obbs[index], { uint32_t(index),0 });
+		}
+		return float(obbSet.Count());
+		}));
+	records.push_back(Measure(config, "OBBSet/Get", kObbCount, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < kObbCount; ++i) {
+			sum += obbSet.Get(handles[i]).center.x;
+		}
+		return sum;
+		}));
+}
+
+//毎フレームのOBBの向きの更新(オイラー角から作り直す方法と、クォータニオンに回転を重ねる方法の比較)
+void RunQuatOBB(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const size_t kObbCount = 65536;
+	const BenchmarkInput input = MakeInput(kObbCount, config.seed);
+	OBBSoA obbs = input.obbSoA;
+	std::vector<Vector3> rotates = input.rotates;
+	QuatOBBSoA quatObbs;
+	for (size_t i = 0; i < kObbCount; ++i) {
+		quatObbs.PushBack(MakeQuatOBB(input.obbs[i].center, input.rotates[i], input.obbs[i].size));
+	}
+	const Vector3 kSpin = { 0.3f,-1.2f,0.7f };
+	const float kDeltaTime = 1.0f / 60.0f;
+
+	records.push_back(Measure(config, "OBBRotationUpdate/euler", kObbCount, [&]() {
+		for (size_t i = 0; i < kObbCount; ++i) {
+			rotates[i] = Add(rotates[i], Multiply(kDeltaTime, kSpin));
+			Matrix4x4 rotateMatrix = MakeRotateXYZMatrix(rotates[i]);
+			for (int axis = 0; axis < 3; ++axis) {
+				for (int component = 0; component < 3; ++component) {
+					obbs.orientations[axis][component][i] = rotateMatrix.m[axis][component];
+				}
+			}
+		}
+		return obbs.orientations[2][2][kObbCount - 1];
+		}));
+	const Quaternion delta = MakeDeltaRotation(kSpin, kDeltaTime);
+	records.push_back(Measure(config, "OBBRotationUpdate/quaternion", kObbCount, [&]() {
+		ApplyDeltaRotation(quatObbs, delta);
+		RenormalizeQuaternions(quatObbs);
+		return quatObbs.rotationW[kObbCount - 1];
+		}));
+	records.push_back(Measure(config, "OBBRotationUpdate/quaternion+expand", kObbCount, [&]() {
+		ApplyDeltaRotation(quatObbs, delta);
+		RenormalizeQuaternions(quatObbs);
+		ExpandQuatOBBs(quatObbs, obbs);
+		return obbs.orientations[2][2][kObbCount - 1];
+		}));
+}
+
+//動くOBB同士の衝突時刻(保守的前進と、細かく区切って静止判定する方法の比較)
+void RunSweptCollision(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const size_t kObbCount = 1024;
+	const uint32_t kSubSteps = 16;
+	const BenchmarkInput input = MakeInput(kObbCount, config.seed);
+	std::mt19937 random(config.seed);
+	std::uniform_real_distribution<float> velocity(-2.0f, 2.0f);
+	std::uniform_real_distribution<float> spin(-0.5f, 0.5f);
+	std::vector<SweptOBB> obbs(kObbCount);
+	for (size_t i = 0; i < kObbCount; ++i) {
+		const OBB& obb = input.obbs[i];
+		Quaternion rotation = MakeRotateXYZQuaternion(input.rotates[i]);
+		Vector3 move = { velocity(random),velocity(random),velocity(random) };
+		obbs[i].start = { obb.center,rotation };
+		obbs[i].end = { Add(obb.center, move),Multiply(MakeRotateXYZQuaternion({ spin(random),spin(random),spin(random) }), rotation) };
+		obbs[i].size = Multiply(0.3f, obb.size);
+	}
+	//近いものだけを組にする(広域判定の後を想定)
+	std::vector<ObbPair> pairs;
+	for (uint32_t a = 0; a < kObbCount; ++a) {
+		for (uint32_t b = a + 1; b < kObbCount; ++b) {
+			if (Length(Subtract(obbs[a].start.center, obbs[b].start.center)) < 4.0f) {
+				pairs.push_back({ a,b });
+			}
+		}
+	}
+	std::vector<uint8_t> hits(pairs.size());
+	std::vector<float> tois(pairs.size());
+
+	records.push_back(Measure(config, "SweptObbObb/conservative-advancement", pairs.size(), [&]() {
+		return float(SweptObbObbTimeOfImpactBatch(obbs, pairs.data(), pairs.size(), hits.data(), tois.data()));
+		}));
+	//区切った時刻ごとに静止判定する(区切りの間は見逃す)
+	records.push_back(Measure(config, "SweptObbObb/substep16", pairs.size(), [&]() {
+		size_t hitCount = 0;
+		for (size_t i = 0; i < pairs.size(); ++i) {
+			for (uint32_t step = 0; step <= kSubSteps; ++step) {
+				float t = float(step) / float(kSubSteps);
+				if (ObbObbIsCollision(GetSweptOBBAt(obbs[pairs[i].a], t), GetSweptOBBAt(obbs[pairs[i].b], t))) {
+					++hitCount;
+					break;
+				}
+			}
+		}
+		return float(hitCount);
+		}));
+	std::vector<uint8_t> segmentHits(kObbCount);
+	std::vector<float> segmentTois(kObbCount);
+	records.push_back(Measure(config, "SweptObbSegment/batch", kObbCount, [&]() {
+		return float(SweptObbSegmentTimeOfImpactBatch(obbs, input.segments[0], segmentHits.data(), segmentTois.data()));
+		}));
+}
+
+//フレームごとの一時バッファ(FrameArenaと毎フレーム作るstd::vector)と、それを使うOBBの線の追加
+void RunFrameArena(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const size_t kObbCount = 1024;
+	const BenchmarkInput input = MakeInput(kObbCount, config.seed);
+	Camera camera;
+	camera.translate = { 0.0f,0.0f,-40.0f };
+	camera.Update();
+	std::vector<uint32_t> indices(kObbCount);
+	for (size_t i = 0; i < kObbCount; ++i) {
+		indices[i] = uint32_t(i);
+	}
+
+	FrameArena arena(1024);
+	records.push_back(Measure(config, "FrameArena/buffers", kObbCount, [&]() {
+		std::span<uint32_t> frameIndices = arena.CopySpan<uint32_t>(indices);
+		std::span<Vector3> worldVertices = arena.AllocateSpan<Vector3>(kObbCount * 8);
+		std::span<Vector4> clipVertices = arena.AllocateSpan<Vector4>(kObbCount * 8);
+		worldVertices[0].x = float(frameIndices[kObbCount - 1]);
+		clipVertices[0].x = worldVertices[0].x;
+		float result = clipVertices[0].x;
+		arena.EndFrame();
+		return result;
+		}));
+	records.push_back(Measure(config, "std::vector/buffers", kObbCount, [&]() {
+		std::vector<uint32_t> frameIndices(indices);
+		std::vector<Vector3> worldVertices(kObbCount * 8);
+		std::vector<Vector4> clipVertices(kObbCount * 8);
+		worldVertices[0].x = float(frameIndices[kObbCount - 1]);
+		clipVertices[0].x = worldVertices[0].x;
+		return clipVertices[0].x;
+		}));
+
+	LineBatch batch;
+	records.push_back(Measure(config, "AddOBBLines/single", kObbCount, [&]() {
+		batch.Clear();
+		for (size_t i = 0; i < kObbCount; ++i) {
+			AddOBBLines(batch, input.obbs[i], camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), 0xFFFFFFFF);
+		}
+		return float(batch.GetLineCount());
+		}));
+	records.push_back(Measure(config, "AddOBBLines/arena-batched", kObbCount, [&]() {
+		batch.Clear();
+		AddOBBLines(batch, input.obbSoA.View(), indices, camera.GetViewProjectionMatrix(), camera.GetViewportMatrix(), 0xFFFFFFFF, arena);
+		arena.EndFrame();
+		return float(batch.GetLineCount());
+		}));
+}
+
+//シーンファイルの割り当てと検査、テキストからの読み込みの比較
+bool RunSceneFile(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	const size_t kCount = 65536;
+	const BenchmarkInput input = MakeInput(kCount, config.seed);
+	const std::string binaryPath = (std::filesystem::temp_directory_path() / "MT2Benchmark.mt2scene").string();
+	const std::string textPath = (std::filesystem::temp_directory_path() / "MT2Benchmark.txt").string();
+
+	SceneFileResult result = WriteSceneFile(binaryPath.c_str(), input.obbSoA.View(), input.segmentSoA.View());
+	FILE* text = std::fopen(textPath.c_str(), "w");
+	if (result != SceneFileResult::kOk || !text) {
+		std::fprintf(stderr, "cannot write scene files: %s\n", GetSceneFileResultName(result));
+		if (text) {
+			std::fclose(text);
+		}
+		return false;
+	}
+	for (size_t i = 0; i < kCount; ++i) {
+		const OBB& obb = input.obbs[i];
+		const Segment& segment = input.segments[i];
+		std::fprintf(text, "obb %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n", obb.center.x, obb.center.y, obb.center.z,
+			input.rotates[i].x, input.rotates[i].y, input.rotates[i].z, obb.size.x, obb.size.y, obb.size.z);
+		std::fprintf(text, "segment %.9g %.9g %.9g %.9g %.9g %.9g\n", segment.origin.x, segment.origin.y, segment.origin.z,
+			segment.diff.x, segment.diff.y, segment.diff.z);
+	}
+	std::fclose(text);
+
+	//割り当てた中身が書き出したSoAと一致しなければ計測しない
+	MappedSceneFile scene;
+	size_t badIndex = 0;
+	result = scene.Open(binaryPath.c_str());
+	if (result == SceneFileResult::kOk) {
+		result = ValidateSceneFile(scene, badIndex);
+	}
+	if (result != SceneFileResult::kOk || scene.GetOBBs().count != kCount ||
+		std::memcmp(scene.GetOBBs().orientations[1][2], input.obbSoA.orientations[1][2].data(), kCount * sizeof(float)) != 0 ||
+		std::memcmp(scene.GetSegments().diffZ, input.segmentSoA.diffZ.data(), kCount * sizeof(float)) != 0) {
+		std::fprintf(stderr, "scene file does not match the source: %s\n", GetSceneFileResultName(result));
+		return false;
+	}
+
+	records.push_back(Measure(config, "SceneFile/open", kCount, [&]() {
+		MappedSceneFile opened;
+		opened.Open(binaryPath.c_str());
+		OBBSoAView obbs = opened.GetOBBs();
+		return obbs.centerX[0] + obbs.sizeZ[obbs.count - 1];
+		}));
+	records.push_back(Measure(config, "SceneFile/validate", kCount, [&]() {
+		return float(ValidateSceneFile(scene, badIndex));
+		}));
+	records.push_back(Measure(config, "SceneFile/text-parse", kCount, [&]() {
+		OBBSoA obbs;
+		SegmentSoA segments;
+		size_t errorLine = 0;
+		LoadSceneText(textPath.c_str(), obbs, segments, errorLine);
+		return obbs.centerX.back();
+		}));
+
+	scene.Close();
+	std::remove(binaryPath.c_str());
+	std::remove(textPath.c_str());
+	return true;
+}
+
+//区間計測そのものの負荷
+void RunProfiler(const BenchmarkConfig& config, std::vector<BenchmarkRecord>& records) {
+	//計測中はフレームを開けないのでトレースには含めない
+	BenchmarkConfig untraced = config;
+	untraced.trace.clear();
+	Profiler& profiler = Profiler::Get();
+	const size_t kScopeCount = 1024;
+
+	records.push_back(Measure(untraced, "ProfileScope/recording", kScopeCount, [&]() {
+		profiler.BeginFrame();
+		for (size_t i = 0; i < kScopeCount; ++i) {
+			MT2_PROFILE_SCOPE("ProfileScope");
+		}
+		profiler.EndFrame();
+		return float(profiler.GetFrame(0).events.size());
+		}));
+	//フレームの外では記録せずにすぐ戻る
+	records.push_back(Measure(untraced, "ProfileScope/idle", kScopeCount, [&]() {
+		for (size_t i = 0; i < kScopeCount; ++i) {
+			MT2_PROFILE_SCOPE("ProfileScope");
+		}
+		return 0.0f;
+		}));
+}
+
+void WriteText(FILE* file, const std::vector<BenchmarkRecord>& records) {
+	std::fprintf(file, "%-40s %10s %14s %12s %16s\n", "name", "batch", "operations", "ns/op", "ops/sec");
+	for (const BenchmarkRecord& record : records) {
+		std::fprintf(file, "%-40s %10zu %14llu %12.3f %16.0f\n", record.name.c_str(), record.batchSize,
+			(unsigned long long)record.operations, record.nsPerOp, record.opsPerSec);
+	}
+}
+
+void WriteCsv(FILE* file, const std::vector<BenchmarkRecord>& records) {
+	std::fprintf(file, "name,batch,operations,ns_per_op,ops_per_sec\n");
+	for (const BenchmarkRecord& record : records) {
+		std::fprintf(file, "%s,%zu,%llu,%.6f,%.3f\n", record.name.c_str(), record.batchSize,
+			(unsigned long long)record.operations, record.nsPerOp, record.opsPerSec);
+	}
+}
+
+void WriteJson(FILE* file, const BenchmarkConfig& config, const std::vector<BenchmarkRecord>& records) {
+	const char* simdNames[] = { "scalar","sse","avx2" };
+	std::fprintf(file, "{\n  \"seed\": %u,\n  \"simd\": \"%s\",\n  \"results\": [\n", config.seed, simdNames[int(GetSimdLevel())]);
+	for (size_t i = 0; i < records.size(); ++i) {
+		const BenchmarkRecord& record = records[i];
+		std::fprintf(file, "    {\"name\": \"%s\", \"batch\": %zu, \"operations\": %llu, \"ns_per_op\": %.6f, \"ops_per_sec\": %.3f}%s\n",
+			record.name.c_str(), record.batchSize, (unsigned long long)record.operations, record.nsPerOp, record.opsPerSec,
+			i + 1 < records.size() ? "," : "");
+	}
+	std::fprintf(file, "  ]\n}\n");
+}
+
+bool ParseArguments(int argc, char** argv, BenchmarkConfig& config) {
+	for (int i = 1; i < argc; ++i) {
+		const char* argument = argv[i];
+		if (std::strncmp(argument, "--format=", 9) == 0) {
+			config.format = argument + 9;
+		}
+		else if (std::strncmp(argument, "--output=", 9) == 0) {
+			config.output = argument + 9;
+		}
+		else if (std::strncmp(argument, "--seed=", 7) == 0) {
+			config.seed = uint32_t(std::strtoul(argument + 7, nullptr, 10));
+		}
+		else if (std::strncmp(argument, "--min-time-ms=", 14) == 0) {
+			config.minTimeMs = std::strtod(argument + 14, nullptr);
+		}
+		else if (std::strncmp(argument, "--trace=", 8) == 0) {
+			config.trace = argument + 8;
+		}
+		else {
+			std::fprintf(stderr, "unknown argument: %s\n", argument);
+			return false;
+		}
+	}
+	if (config.format != "text" && config.format != "csv" && config.format != "json") {
+		std::fprintf(stderr, "unknown format: %s\n", config.format.c_str());
+		return false;
+	}
+	return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+	BenchmarkConfig config;
+	if (!ParseArguments(argc, argv, config)) {
+		std::fprintf(stderr, "usage: MT2Benchmark [--format=text|csv|json] [--output=path] [--seed=N] [--min-time-ms=N] [--trace=path]\n");
+		return 1;
+	}
+
+	//展開した式が以前の計算と一致しなければ計測しない
+	const float kAffineTolerance = 1.0e-5f;
+	float affineError = VerifyMakeAffineMatrix(config.seed);
+	std::fprintf(stderr, "MakeAffineMatrix max error vs reference: %g\n", affineError);
+	if (affineError > kAffineTolerance) {
+		std::fprintf(stderr, "MakeAffineMatrix does not match the reference\n");
+		return 1;
+	}
+	float batchedError = VerifyMakeAffineMatrices(config.seed);
+	std::fprintf(stderr, "MakeAffineMatrices max error vs MakeAffineMatrix: %g\n", batchedError);
+	if (batchedError > kAffineTolerance) {
+		std::fprintf(stderr, "MakeAffineMatrices does not match MakeAffineMatrix\n");
+		return 1;
+	}
+	float constexprError = VerifyConstexprMatrices();
+	std::fprintf(stderr, "constexpr matrices max error vs runtime: %g\n", constexprError);
+	if (constexprError > kAffineTolerance) {
+		std::fprintf(stderr, "constexpr matrices do not match the runtime results\n");
+		return 1;
+	}
+
+	//バッチが小さいとL1に、大きいとメモリに乗る
+	const size_t kBatchSizes[] = { 16,256,4096,65536 };
+	std::vector<BenchmarkRecord> records;
+	RunProfiler(config, records);
+	//トレースには全ての項目を残す
+	if (!config.trace.empty()) {
+		Profiler::Get().SetFrameCapacity(1024);
+	}
+	for (size_t batchSize : kBatchSizes) {
+		RunBatch(config, batchSize, records);
+	}
+	if (!RunScheduler(config, records)) {
+		return 1;
+	}
+	if (!RunSweepAndPrune(config, records)) {
+		return 1;
+	}
+	RunSpatialHashGrid(config, records);
+	RunLineBatch(config, records);
+	RunFrameArena(config, records);
+	RunSweptCollision(config, records);
+	RunQuatOBB(config, records);
+	RunOBBSet(config, records);
+	RunStructuredMatrix(config, records);
+	if (!RunSceneFile(config, records)) {
+		return 1;
+	}
+	if (!config.trace.empty() && !Profiler::Get().WriteChromeTrace(config.trace.c_str())) {
+		std::fprintf(stderr, "cannot open %s\n", config.trace.c_str());
+		return 1;
+	}
+
+	FILE* file = stdout;
+	if (!config.output.empty()) {
+		file = std::fopen(config.output.c_str(), "w");
+		if (!file) {
+			std::fprintf(stderr, "cannot open %s\n", config.output.c_str());
+			return 1;
+		}
+	}
+	if (config.format == "csv") {
+		WriteCsv(file, records);
+	}
+	else if (config.format == "json") {
+		WriteJson(file, config, records);
+	}
+	else {
+		WriteText(file, records);
+	}
+	if (file != stdout) {
+		std::fclose(file);
+	}
+	return 0;
+}
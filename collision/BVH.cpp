@@ -0,0 +1,357 @@
+#include "BVH.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "Profiler.h"
+
+static float GetAxis(const Vector3& v, int axis) {
+	return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+static AABB MergeAABB(const AABB& a, const AABB& b) {
+	return {
+		{ std::min(a.min.x, b.min.x),std::min(a.min.y, b.min.y),std::min(a.min.z, b.min.z) },
+		{ std::max(a.max.x, b.max.x),std::max(a.max.y, b.max.y),std::max(a.max.z, b.max.z) },
+	};
+}
+
+static AABB EmptyAABB() {
+	const float inf = std::numeric_limits<float>::infinity();
+	return { { inf,inf,inf },{ -inf,-inf,-inf } };
+}
+
+static bool OverlapAABB(const AABB& a, const AABB& b) {
+	return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+		a.min.y <= b.max.y && b.min.y <= a.max.y &&
+		a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+//葉のOBBと線分の判定(逆行列は持たずにその場で作る)
+static bool IntersectPrimitive(const Segment& segment, const OBBSoAView& obbs, uint32_t primitive, float& tmin) {
+	OBB obb = GetOBB(obbs, primitive);
+	return ObbSegmentIntersectLocal(segment, obb, InverseRigid(MakeOBBWorldMatrix(obb)), tmin);
+}
+
+static float SurfaceArea(const AABB& aabb) {
+	Vector3 e = Subtract(aabb.max, aabb.min);
+	if (e.x < 0.0f || e.y < 0.0f || e.z < 0.0f) {
+		return 0.0f;
+	}
+	return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+}
+
+void OBBBVH::Build(const OBBSoAView& obbs) {
+	MT2_PROFILE_SCOPE("OBBBVH::Build");
+	nodes_.clear();
+	obbs_ = obbs;
+	indices_.resize(obbs.count);
+	primitiveBounds_.resize(obbs.count);
+	centroids_.resize(obbs.count);
+	for (size_t i = 0; i < obbs.count; ++i) {
+		indices_[i] = uint32_t(i);
+		primitiveBounds_[i] = MakeOBBWorldAABB(GetOBB(obbs, i));
+		centroids_[i] = Multiply(0.5f, Add(primitiveBounds_[i].min, primitiveBounds_[i].max));
+	}
+	if (obbs.count == 0) {
+		return;
+	}
+
+	nodes_.reserve(obbs.count * 2);
+	BVHNode root{};
+	root.leftFirst = 0;
+	root.count = uint32_t(obbs.count);
+	nodes_.push_back(root);
+	UpdateNodeBounds(0);
+	Subdivide(0, 0);
+}
+
+void OBBBVH::UpdateNodeBounds(uint32_t nodeIndex) {
+	BVHNode& node = nodes_[nodeIndex];
+	node.bounds = EmptyAABB();
+	for (uint32_t i = 0; i < node.count; ++i) {
+		node.bounds = MergeAABB(node.bounds, primitiveBounds_[indices_[node.leftFirst + i]]);
+	}
+}
+
+float OBBBVH::FindBestSplit(const BVHNode& node, int& axis, float& splitPosition) const {
+	const int kBinCount = 16;
+	float bestCost = std::numeric_limits<float>::infinity();
+	for (int a = 0; a < 3; ++a) {
+		//重心の範囲を等分したビンに振り分ける
+		float boundsMin = std::numeric_limits<float>::infinity();
+		float boundsMax = -std::numeric_limits<float>::infinity();
+		for (uint32_t i = 0; i < node.count; ++i) {
+			float c = GetAxis(centroids_[indices_[node.leftFirst + i]], a);
+			boundsMin = std::min(boundsMin, c);
+			boundsMax = std::max(boundsMax, c);
+		}
+		if (boundsMin == boundsMax) {
+			continue;
+		}
+
+		AABB binBounds[kBinCount];
+		uint32_t binCount[kBinCount] = {};
+		for (int b = 0; b < kBinCount; ++b) {
+			binBounds[b] = EmptyAABB();
+		}
+		float scale = float(kBinCount) / (boundsMax - boundsMin);
+		for (uint32_t i = 0; i < node.count; ++i) {
+			uint32_t primitive = indices_[node.leftFirst + i];
+			int bin = std::min(kBinCount - 1, int((GetAxis(centroids_[primitive], a) - boundsMin) * scale));
+			binCount[bin]++;
+			binBounds[bin] = MergeAABB(binBounds[bin], primitiveBounds_[primitive]);
+		}
+
+		//ビンの境界ごとに左右のコストを求める
+		float leftArea[kBinCount - 1];
+		float rightArea[kBinCount - 1];
+		uint32_t leftCount[kBinCount - 1];
+		uint32_t rightCount[kBinCount - 1];
+		AABB leftBox = EmptyAABB();
+		AABB rightBox = EmptyAABB();
+		uint32_t leftSum = 0;
+		uint32_t rightSum = 0;
+		for (int b = 0; b < kBinCount - 1; ++b) {
+			leftSum += binCount[b];
+			leftCount[b] = leftSum;
+			leftBox = MergeAABB(leftBox, binBounds[b]);
+			leftArea[b] = SurfaceArea(leftBox);
+			rightSum += binCount[kBinCount - 1 - b];
+			rightCount[kBinCount - 2 - b] = rightSum;
+			rightBox = MergeAABB(rightBox, binBounds[kBinCount - 1 - b]);
+			rightArea[kBinCount - 2 - b] = SurfaceArea(rightBox);
+		}
+		float binWidth = (boundsMax - boundsMin) / float(kBinCount);
+		for (int b = 0; b < kBinCount - 1; ++b) {
+			float cost = float(leftCount[b]) * leftArea[b] + float(rightCount[b]) * rightArea[b];
+			if (cost < bestCost) {
+				bestCost = cost;
+				axis = a;
+				splitPosition = boundsMin + binWidth * float(b + 1);
+			}
+		}
+	}
+	return bestCost;
+}
+
+void OBBBVH::Subdivide(uint32_t nodeIndex, uint32_t depth) {
+	const uint32_t kMaxLeafSize = 2;
+	//探索用のスタックに収まる深さまでにする
+	if (nodes_[nodeIndex].count <= kMaxLeafSize || depth >= kMaxDepth) {
+		return;
+	}
+
+	int axis = 0;
+	float splitPosition = 0.0f;
+	float splitCost = FindBestSplit(nodes_[nodeIndex], axis, splitPosition);
+	//分割しない方が安いなら葉のままにする
+	float leafCost = float(nodes_[nodeIndex].count) * SurfaceArea(nodes_[nodeIndex].bounds);
+	if (splitCost >= leafCost) {
+		return;
+	}
+
+	uint32_t first = nodes_[nodeIndex].leftFirst;
+	uint32_t count = nodes_[nodeIndex].count;
+	auto begin = indices_.begin() + first;
+	auto middle = std::partition(begin, begin + count, [&](uint32_t primitive) {
+		return GetAxis(centroids_[primitive], axis) < splitPosition;
+		});
+	uint32_t i = first + uint32_t(middle - begin);
+	uint32_t leftCount = i - first;
+	if (leftCount == 0 || leftCount == count) {
+		return;
+	}
+
+	uint32_t leftIndex = uint32_t(nodes_.size());
+	BVHNode left{};
+	left.leftFirst = first;
+	left.count = leftCount;
+	BVHNode right{};
+	right.leftFirst = i;
+	right.count = count - leftCount;
+	nodes_.push_back(left);
+	nodes_.push_back(right);
+	nodes_[nodeIndex].leftFirst = leftIndex;
+	nodes_[nodeIndex].count = 0;
+	UpdateNodeBounds(leftIndex);
+	UpdateNodeBounds(leftIndex + 1);
+	Subdivide(leftIndex, depth + 1);
+	Subdivide(leftIndex + 1, depth + 1);
+}
+
+void OBBBVH::Refit(const OBBSoAView& obbs) {
+	MT2_PROFILE_SCOPE("OBBBVH::Refit");
+	assert(obbs.count == obbs_.count);
+	obbs_ = obbs;
+	for (size_t i = 0; i < obbs.count; ++i) {
+		primitiveBounds_[i] = MakeOBBWorldAABB(GetOBB(obbs, i));
+	}
+	//子は必ず親より後ろにあるので、後ろから更新すれば子が先に終わる
+	for (size_t n = nodes_.size(); n-- > 0;) {
+		BVHNode& node = nodes_[n];
+		if (node.count > 0) {
+			UpdateNodeBounds(uint32_t(n));
+		}
+		else {
+			node.bounds = MergeAABB(nodes_[node.leftFirst].bounds, nodes_[node.leftFirst + 1].bounds);
+		}
+	}
+}
+
+template<typename Visitor>
+void OBBBVH::VisitSegmentHits(const Segment& segment, Visitor&& visitor) const {
+	if (nodes_.empty()) {
+		return;
+	}
+	const float origin[3] = { segment.origin.x,segment.origin.y,segment.origin.z };
+	const float invDiff[3] = { 1.0f / segment.diff.x,1.0f / segment.diff.y,1.0f / segment.diff.z };
+
+	uint32_t stack[kMaxDepth + 2];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const BVHNode& node = nodes_[stack[--stackSize]];
+		float tEnter;
+		if (!SlabTestInverse(node.bounds, origin, invDiff, 0.0f, 1.0f, tEnter)) {
+			continue;
+		}
+		if (node.count > 0) {
+			for (uint32_t i = 0; i < node.count; ++i) {
+				uint32_t primitive = indices_[node.leftFirst + i];
+				float tmin;
+				//OBBは15本の配列に散らばっているので、先にまとまっているAABBで弾く
+				if (!SlabTestInverse(primitiveBounds_[primitive], origin, invDiff, 0.0f, 1.0f, tmin)) {
+					continue;
+				}
+				if (IntersectPrimitive(segment, obbs_, primitive, tmin)) {
+					visitor(primitive, tmin);
+				}
+			}
+		}
+		else {
+			stack[stackSize++] = node.leftFirst;
+			stack[stackSize++] = node.leftFirst + 1;
+		}
+	}
+}
+
+void OBBBVH::QuerySegment(const Segment& segment, std::vector<uint32_t>& hitIndices) const {
+	hitIndices.clear();
+	VisitSegmentHits(segment, [&](uint32_t primitive, float) {
+		hitIndices.push_back(primitive);
+		});
+}
+
+void OBBBVH::QuerySegment(const Segment& segment, std::vector<uint32_t>& hitIndices, std::vector<float>& hitTs) const {
+	hitIndices.clear();
+	hitTs.clear();
+	VisitSegmentHits(segment, [&](uint32_t primitive, float t) {
+		hitIndices.push_back(primitive);
+		hitTs.push_back(t);
+		});
+}
+
+void OBBBVH::QueryAABB(const AABB& aabb, std::vector<uint32_t>& hitIndices) const {
+	hitIndices.clear();
+	if (nodes_.empty()) {
+		return;
+	}
+	uint32_t stack[kMaxDepth + 2];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const BVHNode& node = nodes_[stack[--stackSize]];
+		if (!OverlapAABB(node.bounds, aabb)) {
+			continue;
+		}
+		if (node.count > 0) {
+			for (uint32_t i = 0; i < node.count; ++i) {
+				uint32_t primitive = indices_[node.leftFirst + i];
+				if (OverlapAABB(primitiveBounds_[primitive], aabb)) {
+					hitIndices.push_back(primitive);
+				}
+			}
+		}
+		else {
+			stack[stackSize++] = node.leftFirst;
+			stack[stackSize++] = node.leftFirst + 1;
+		}
+	}
+}
+
+bool OBBBVH::ClosestHit(const Segment& segment, uint32_t& hitIndex, float& hitT) const {
+	if (nodes_.empty()) {
+		return false;
+	}
+	const float origin[3] = { segment.origin.x,segment.origin.y,segment.origin.z };
+	const float invDiff[3] = { 1.0f / segment.diff.x,1.0f / segment.diff.y,1.0f / segment.diff.z };
+
+	bool found = false;
+	float bestT = 1.0f;
+	uint32_t stack[kMaxDepth + 2];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const BVHNode& node = nodes_[stack[--stackSize]];
+		float tEnter;
+		//今までで一番近いヒットより奥のノードは見ない
+		if (!SlabTestInverse(node.bounds, origin, invDiff, 0.0f, bestT, tEnter)) {
+			continue;
+		}
+		if (node.count > 0) {
+			for (uint32_t i = 0; i < node.count; ++i) {
+				uint32_t primitive = indices_[node.leftFirst + i];
+				float tmin;
+				if (!SlabTestInverse(primitiveBounds_[primitive], origin, invDiff, 0.0f, bestT, tmin)) {
+					continue;
+				}
+				if (IntersectPrimitive(segment, obbs_, primitive, tmin) && (!found || tmin < bestT)) {
+					found = true;
+					bestT = tmin;
+					hitIndex = primitive;
+				}
+			}
+			continue;
+		}
+
+		//近い方の子を後に積んで先に調べる
+		uint32_t left = node.leftFirst;
+		uint32_t right = node.leftFirst + 1;
+		float tLeft;
+		float tRight;
+		bool hitLeft = SlabTestInverse(nodes_[left].bounds, origin, invDiff, 0.0f, bestT, tLeft);
+		bool hitRight = SlabTestInverse(nodes_[right].bounds, origin, invDiff, 0.0f, bestT, tRight);
+		if (hitLeft && hitRight) {
+			if (tLeft <= tRight) {
+				stack[stackSize++] = right;
+				stack[stackSize++] = left;
+			}
+			else {
+				stack[stackSize++] = left;
+				stack[stackSize++] = right;
+			}
+		}
+		else if (hitLeft) {
+			stack[stackSize++] = left;
+		}
+		else if (hitRight) {
+			stack[stackSize++] = right;
+		}
+	}
+	if (found) {
+		hitT = bestT;
+	}
+	return found;
+}
+
+bool OBBBVH::ClosestHit(const Segment& segment, uint32_t& hitIndex, SegmentHit& hit) const {
+	float hitT;
+	if (!ClosestHit(segment, hitIndex, hitT)) {
+		return false;
+	}
+	//点と法線は最も近いOBBについてだけ求める
+	OBB obb = GetOBB(obbs_, hitIndex);
+	ObbSegmentIntersectLocal(segment, obb, InverseRigid(MakeOBBWorldMatrix(obb)), hit);
+	return true;
+}
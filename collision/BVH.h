@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Collision.h"
+
+//BVHのノード
+struct BVHNode {
+	AABB bounds;
+	uint32_t leftFirst;//内部ノードなら左の子の番号、葉なら最初のプリミティブの番号
+	uint32_t count;//葉のプリミティブ数(0なら内部ノード)
+};
+
+//OBB群に対するBVH(ノードはワールド空間のAABB)
+//OBBはコピーせずに渡された配列をそのまま読む(割り当てたシーンファイルでも読み込みのコストがかからない)
+//判定に使う逆行列も持たず、葉で判定するときに作る
+class OBBBVH {
+public:
+	//binned SAHで構築する(obbsの配列はBVHを使う間は有効であること)
+	void Build(const OBBSoAView& obbs);
+	//木の形は変えずにバウンディングだけ更新する(OBBの数と順番は構築時と同じであること)
+	void Refit(const OBBSoAView& obbs);
+	//線分と当たる全てのOBBの番号を集める
+	void QuerySegment(const Segment& segment, std::vector<uint32_t>& hitIndices) const;
+	//線分と当たる全てのOBBの番号と進入時刻を集める
+	void QuerySegment(const Segment& segment, std::vector<uint32_t>& hitIndices, std::vector<float>& hitTs) const;
+	//AABBと重なる葉のOBBの番号を集める(OBB自体とは判定しない)
+	void QueryAABB(const AABB& aabb, std::vector<uint32_t>& hitIndices) const;
+	//線分と最初に当たるOBBを求める
+	bool ClosestHit(const Segment& segment, uint32_t& hitIndex, float& hitT) const;
+	//最初に当たるOBBとその交差結果を求める
+	bool ClosestHit(const Segment& segment, uint32_t& hitIndex, SegmentHit& hit) const;
+
+	const std::vector<BVHNode>& GetNodes() const { return nodes_; }
+
+	static const uint32_t kMaxDepth = 60;
+
+private:
+	void UpdateNodeBounds(uint32_t nodeIndex);
+	void Subdivide(uint32_t nodeIndex, uint32_t depth);
+	float FindBestSplit(const BVHNode& node, int& axis, float& splitPosition) const;
+	//線分と当たるOBBごとにvisitor(番号, 進入時刻)を呼ぶ
+	template<typename Visitor>
+	void VisitSegmentHits(const Segment& segment, Visitor&& visitor) const;
+
+	std::vector<BVHNode> nodes_;
+	std::vector<uint32_t> indices_;
+	OBBSoAView obbs_{};
+	std::vector<AABB> primitiveBounds_;
+	std::vector<Vector3> centroids_;
+};
@@ -0,0 +1,674 @@
+#include "Collision.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "FrameArena.h"
+
+bool AabbSegmentIsCollision(const AABB& aabb, const Segment& segment) {
+	float tmin;
+	float tmax;
+	return AabbSegmentIntersect(aabb, segment, tmin, tmax);
+}
+
+//1軸分のスラブ判定。軸と平行な場合は始点がスラブ内なら(-inf,inf)、外なら空区間にする
+static void SlabAxis(float slabMin, float slabMax, float origin, float diff, float& tNear, float& tFar) {
+	if (diff == 0.0f) {
+		if (slabMin <= origin && origin <= slabMax) {
+			tNear = -std::numeric_limits<float>::infinity();
+			tFar = std::numeric_limits<float>::infinity();
+		}
+		else {
+			tNear = std::numeric_limits<float>::infinity();
+			tFar = -std::numeric_limits<float>::infinity();
+		}
+		return;
+	}
+	float t0 = (slabMin - origin) / diff;
+	float t1 = (slabMax - origin) / diff;
+	tNear = std::min(t0, t1);
+	tFar = std::max(t0, t1);
+}
+
+//スラブ判定の本体。tNearには軸ごとの入る時刻を返す
+static inline bool AabbSegmentIntersectNear(const AABB& aabb, const Segment& segment, float tNear[3], float& tmin, float& tmax) {
+	float tFarX, tFarY, tFarZ;
+	SlabAxis(aabb.min.x, aabb.max.x, segment.origin.x, segment.diff.x, tNear[0], tFarX);
+	SlabAxis(aabb.min.y, aabb.max.y, segment.origin.y, segment.diff.y, tNear[1], tFarY);
+	SlabAxis(aabb.min.z, aabb.max.z, segment.origin.z, segment.diff.z, tNear[2], tFarZ);
+
+	//AABBとの衝突点（貫通点）のtが小さい方(線分なので0～1に収める)
+	tmin = std::max(std::max(std::max(tNear[0], tNear[1]), tNear[2]), 0.0f);
+	//AABBとの衝突点（貫通点）のtが大きい方
+	tmax = std::min(std::min(std::min(tFarX, tFarY), tFarZ), 1.0f);
+	if (tmin <= tmax) {
+		return true;
+	}
+	else {
+		return false;
+	}
+}
+
+//最後に入ったスラブの軸が入る面になる(始点が箱の中なら-1)
+//当たった時だけ呼ぶので、判定本体には分岐を増やさない
+static int GetEnterAxis(const float tNear[3]) {
+	float tNearMax = std::max(std::max(tNear[0], tNear[1]), tNear[2]);
+	if (tNearMax < 0.0f) {
+		return -1;
+	}
+	if (tNear[0] == tNearMax) {
+		return 0;
+	}
+	if (tNear[1] == tNearMax) {
+		return 1;
+	}
+	return 2;
+}
+
+bool AabbSegmentIntersect(const AABB& aabb, const Segment& segment, float& tmin, float& tmax) {
+	float tNear[3];
+	return AabbSegmentIntersectNear(aabb, segment, tNear, tmin, tmax);
+}
+
+bool AabbSegmentIntersect(const AABB& aabb, const Segment& segment, SegmentHit& hit) {
+	float tNear[3];
+	if (!AabbSegmentIntersectNear(aabb, segment, tNear, hit.tEnter, hit.tExit)) {
+		return false;
+	}
+	int enterAxis = GetEnterAxis(tNear);
+	hit.point = Add(segment.origin, Multiply(hit.tEnter, segment.diff));
+	hit.normal = { 0.0f,0.0f,0.0f };
+	if (enterAxis == 0) {
+		hit.normal.x = segment.diff.x > 0.0f ? -1.0f : 1.0f;
+	}
+	else if (enterAxis == 1) {
+		hit.normal.y = segment.diff.y > 0.0f ? -1.0f : 1.0f;
+	}
+	else if (enterAxis == 2) {
+		hit.normal.z = segment.diff.z > 0.0f ? -1.0f : 1.0f;
+	}
+	return true;
+}
+
+bool ObbSegmentIsCollision(const Segment& segment, const OBB& obb) {
+	//float tXmin = (-obb.size.x - segment.origin.x) / segment.diff.x;
+	//float tXmax = (obb.size.x - segment.origin.x) / segment.diff.x;
+	//float tYmin = (-obb.size.y - segment.origin.y) / segment.diff.y;
+	//float tYmax = (obb.size.y - segment.origin.y) / segment.diff.y;
+	//float tZmin = (-obb.size.z - segment.origin.z) / segment.diff.z;
+	//float tZmax = (obb.size.z - segment.origin.z) / segment.diff.z;
+
+	//float tNearX = std::min(tXmin, tXmax);
+	//float tNearY = std::min(tYmin, tYmax);
+	//float tNearZ = std::min(tZmin, tZmax);
+	//float tFarX = std::max(tXmin, tXmax);
+	//float tFarY = std::max(tYmin, tYmax);
+	//float tFarZ = std::max(tZmin, tZmax);
+
+	////AABBとの衝突点（貫通点）のtが小さい方
+	//float tmin = std::max(std::max(tNearX, tNearY), tNearZ);
+	////AABBとの衝突点（貫通点）のtが大きい方
+	//float tmax = std::min(std::min(tFarX, tFarY), tFarZ);
+	//if (tmin <= tmax) {
+	//	return true;
+	//}
+	//else {
+	//	return false;
+	//}
+
+	Matrix4x4 obbWorldMatrixInverce = InverseRigid(MakeOBBWorldMatrix(obb));
+
+	float tmin;
+	if (ObbSegmentIntersectLocal(segment, obb, obbWorldMatrixInverce, tmin)) {
+		return true;
+	}
+	else {
+		return false;
+	}
+}
+
+//OBBのワールド行列
+Matrix4x4 MakeOBBWorldMatrix(const OBB& obb) {
+	Matrix4x4 worldMatrix = {
+	obb.orientations[0].x,obb.orientations[0].y,obb.orientations[0].z,0,
+	obb.orientations[1].x,obb.orientations[1].y,obb.orientations[1].z,0,
+	obb.orientations[2].x,obb.orientations[2].y,obb.orientations[2].z,0,
+	obb.center.x,obb.center.y,obb.center.z,1
+	};
+	return worldMatrix;
+}
+
+bool ObbSegmentIntersectLocal(const Segment& segment, const OBB& obb, const Matrix4x4& obbWorldMatrixInverse, float& tmin) {
+	Vector3 localOrigin = TransformPoint(segment.origin, obbWorldMatrixInverse);
+	Vector3 localDiff = TransformDirection(segment.diff, obbWorldMatrixInverse);
+
+	AABB localAABB{
+		{-obb.size.x,-obb.size.y,-obb.size.z},
+		{obb.size.x,obb.size.y,obb.size.z},
+	};
+
+	Segment localSegment;
+	localSegment.origin = localOrigin;
+	localSegment.diff = localDiff;
+
+	float tmax;
+	return AabbSegmentIntersect(localAABB, localSegment, tmin, tmax);
+}
+
+bool ObbSegmentIntersectLocal(const Segment& segment, const OBB& obb, const Matrix4x4& obbWorldMatrixInverse, SegmentHit& hit) {
+	Segment localSegment;
+	localSegment.origin = TransformPoint(segment.origin, obbWorldMatrixInverse);
+	localSegment.diff = TransformDirection(segment.diff, obbWorldMatrixInverse);
+
+	AABB localAABB{
+		{-obb.size.x,-obb.size.y,-obb.size.z},
+		{obb.size.x,obb.size.y,obb.size.z},
+	};
+
+	//外れる場合がほとんどなので、hitには当たった時だけ書き込む
+	float tNear[3];
+	float tEnter;
+	float tExit;
+	if (!AabbSegmentIntersectNear(localAABB, localSegment, tNear, tEnter, tExit)) {
+		return false;
+	}
+	int enterAxis = GetEnterAxis(tNear);
+	hit.tEnter = tEnter;
+	hit.tExit = tExit;
+	//tは剛体変換で変わらないので、点はワールドの線分から、法線はOBBの軸から直接求める
+	hit.point.x = segment.origin.x + segment.diff.x * tEnter;
+	hit.point.y = segment.origin.y + segment.diff.y * tEnter;
+	hit.point.z = segment.origin.z + segment.diff.z * tEnter;
+	if (enterAxis < 0) {
+		hit.normal = { 0.0f,0.0f,0.0f };
+	}
+	else {
+		const float localDiff[3] = { localSegment.diff.x,localSegment.diff.y,localSegment.diff.z };
+		float sign = localDiff[enterAxis] > 0.0f ? -1.0f : 1.0f;
+		const Vector3& axis = obb.orientations[enterAxis];
+		hit.normal = { axis.x * sign,axis.y * sign,axis.z * sign };
+	}
+	return true;
+}
+
+bool ObbSegmentIntersect(const Segment& segment, const OBB& obb, SegmentHit& hit) {
+	return ObbSegmentIntersectLocal(segment, obb, InverseRigid(MakeOBBWorldMatrix(obb)), hit);
+}
+
+Segment GetSegment(const SegmentSoAView& segments, size_t index) {
+	Segment segment;
+	segment.origin = { segments.originX[index],segments.originY[index],segments.originZ[index] };
+	segment.diff = { segments.diffX[index],segments.diffY[index],segments.diffZ[index] };
+	return segment;
+}
+
+OBB GetOBB(const OBBSoAView& obbs, size_t index) {
+	OBB obb;
+	obb.center = { obbs.centerX[index],obbs.centerY[index],obbs.centerZ[index] };
+	for (int axis = 0; axis < 3; ++axis) {
+		obb.orientations[axis].x = obbs.orientations[axis][0][index];
+		obb.orientations[axis].y = obbs.orientations[axis][1][index];
+		obb.orientations[axis].z = obbs.orientations[axis][2][index];
+	}
+	obb.size = { obbs.sizeX[index],obbs.sizeY[index],obbs.sizeZ[index] };
+	return obb;
+}
+
+void ObbSegmentIsCollisionBatch(const SegmentSoAView& segments, const OBBSoAView& obbs, uint8_t* hitMasks, float* tEnters,
+	std::span<OBB> localObbs, std::span<Matrix4x4> inverses) {
+	assert(localObbs.size() >= obbs.count && inverses.size() >= obbs.count);
+	//OBBごとの逆行列はバッチ内で一度だけ計算する
+	for (size_t obbIndex = 0; obbIndex < obbs.count; ++obbIndex) {
+		localObbs[obbIndex] = GetOBB(obbs, obbIndex);
+		inverses[obbIndex] = InverseRigid(MakeOBBWorldMatrix(localObbs[obbIndex]));
+	}
+
+	for (size_t segmentIndex = 0; segmentIndex < segments.count; ++segmentIndex) {
+		Segment segment = GetSegment(segments, segmentIndex);
+		uint8_t* hitRow = hitMasks + segmentIndex * obbs.count;
+		float* tRow = tEnters + segmentIndex * obbs.count;
+		for (size_t obbIndex = 0; obbIndex < obbs.count; ++obbIndex) {
+			float tmin;
+			if (ObbSegmentIntersectLocal(segment, localObbs[obbIndex], inverses[obbIndex], tmin)) {
+				hitRow[obbIndex] = 1;
+				tRow[obbIndex] = tmin;
+			}
+			else {
+				hitRow[obbIndex] = 0;
+				tRow[obbIndex] = std::numeric_limits<float>::infinity();
+			}
+		}
+	}
+}
+
+void ObbSegmentIsCollisionBatch(const SegmentSoAView& segments, const OBBSoAView& obbs, uint8_t* hitMasks, float* tEnters, FrameArena& arena) {
+	ObbSegmentIsCollisionBatch(segments, obbs, hitMasks, tEnters, arena.AllocateSpan<OBB>(obbs.count), arena.AllocateSpan<Matrix4x4>(obbs.count));
+}
+
+//分離軸判定で使うOBBの軸と半分の大きさ
+struct SatBox {
+	float center[3];
+	float axes[3][3];//[軸][成分]
+	float halfExtents[3];
+};
+
+static SatBox MakeSatBox(const OBB& obb) {
+	SatBox box;
+	box.center[0] = obb.center.x;
+	box.center[1] = obb.center.y;
+	box.center[2] = obb.center.z;
+	for (int axis = 0; axis < 3; ++axis) {
+		box.axes[axis][0] = obb.orientations[axis].x;
+		box.axes[axis][1] = obb.orientations[axis].y;
+		box.axes[axis][2] = obb.orientations[axis].z;
+	}
+	box.halfExtents[0] = obb.size.x;
+	box.halfExtents[1] = obb.size.y;
+	box.halfExtents[2] = obb.size.z;
+	return box;
+}
+
+static SatBox LoadSatBox(const OBBSoAView& obbs, size_t index) {
+	SatBox box;
+	box.center[0] = obbs.centerX[index];
+	box.center[1] = obbs.centerY[index];
+	box.center[2] = obbs.centerZ[index];
+	for (int axis = 0; axis < 3; ++axis) {
+		for (int component = 0; component < 3; ++component) {
+			box.axes[axis][component] = obbs.orientations[axis][component][index];
+		}
+	}
+	box.halfExtents[0] = obbs.sizeX[index];
+	box.halfExtents[1] = obbs.sizeY[index];
+	box.halfExtents[2] = obbs.sizeZ[index];
+	return box;
+}
+
+static float Dot3(const float a[3], const float b[3]) {
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+//15軸の分離軸判定。contactがnullptrなら深さは求めない
+//軸はaの座標系で計算する(軸ベクトルは正規直交であること)
+static bool SatTest(const SatBox& a, const SatBox& b, ObbContact* contact) {
+	//平行な辺の外積が0になって誤判定しないように少し足す
+	const float kEpsilon = 1.0e-6f;
+
+	float r[3][3];
+	float absR[3][3];
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			r[i][j] = Dot3(a.axes[i], b.axes[j]);
+			absR[i][j] = std::abs(r[i][j]) + kEpsilon;
+		}
+	}
+	const float d[3] = { b.center[0] - a.center[0],b.center[1] - a.center[1],b.center[2] - a.center[2] };
+	const float t[3] = { Dot3(d, a.axes[0]),Dot3(d, a.axes[1]),Dot3(d, a.axes[2]) };
+	const float* ea = a.halfExtents;
+	const float* eb = b.halfExtents;
+
+	float bestDepth = std::numeric_limits<float>::infinity();
+	float bestAxis[3] = { 1.0f,0.0f,0.0f };//aの座標系
+	auto Consider = [&](float distance, float radius, float scale, float x, float y, float z) {
+		float depth = (radius - std::abs(distance)) / scale;
+		if (depth < bestDepth) {
+			float sign = distance < 0.0f ? -1.0f : 1.0f;
+			bestDepth = depth;
+			bestAxis[0] = x * sign / scale;
+			bestAxis[1] = y * sign / scale;
+			bestAxis[2] = z * sign / scale;
+		}
+		};
+
+	//aの面の法線
+	for (int i = 0; i < 3; ++i) {
+		float radius = ea[i] + eb[0] * absR[i][0] + eb[1] * absR[i][1] + eb[2] * absR[i][2];
+		if (std::abs(t[i]) > radius) {
+			return false;
+		}
+		if (contact) {
+			Consider(t[i], radius, 1.0f, i == 0 ? 1.0f : 0.0f, i == 1 ? 1.0f : 0.0f, i == 2 ? 1.0f : 0.0f);
+		}
+	}
+	//bの面の法線
+	for (int j = 0; j < 3; ++j) {
+		float radius = ea[0] * absR[0][j] + ea[1] * absR[1][j] + ea[2] * absR[2][j] + eb[j];
+		float distance = t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j];
+		if (std::abs(distance) > radius) {
+			return false;
+		}
+		if (contact) {
+			Consider(distance, radius, 1.0f, r[0][j], r[1][j], r[2][j]);
+		}
+	}
+	//辺同士の外積 a[i]×b[j]
+	for (int i = 0; i < 3; ++i) {
+		int i1 = (i + 1) % 3;
+		int i2 = (i + 2) % 3;
+		for (int j = 0; j < 3; ++j) {
+			int j1 = (j + 1) % 3;
+			int j2 = (j + 2) % 3;
+			float radius = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j] + eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+			float distance = t[i2] * r[i1][j] - t[i1] * r[i2][j];
+			if (std::abs(distance) > radius) {
+				return false;
+			}
+			if (contact) {
+				//平行な辺の組は面の軸で判定済みなので深さには使わない
+				float lengthSq = 1.0f - r[i][j] * r[i][j];
+				if (lengthSq > kEpsilon) {
+					float axis[3];
+					axis[i] = 0.0f;
+					axis[i1] = -r[i2][j];
+					axis[i2] = r[i1][j];
+					Consider(distance, radius, std::sqrt(lengthSq), axis[0], axis[1], axis[2]);
+				}
+			}
+		}
+	}
+
+	if (contact) {
+		//aの座標系からワールドへ戻す
+		contact->axis.x = bestAxis[0] * a.axes[0][0] + bestAxis[1] * a.axes[1][0] + bestAxis[2] * a.axes[2][0];
+		contact->axis.y = bestAxis[0] * a.axes[0][1] + bestAxis[1] * a.axes[1][1] + bestAxis[2] * a.axes[2][1];
+		contact->axis.z = bestAxis[0] * a.axes[0][2] + bestAxis[1] * a.axes[1][2] + bestAxis[2] * a.axes[2][2];
+		contact->depth = bestDepth;
+	}
+	return true;
+}
+
+bool ObbObbIsCollision(const OBB& a, const OBB& b) {
+	return SatTest(MakeSatBox(a), MakeSatBox(b), nullptr);
+}
+
+bool ObbObbIntersect(const OBB& a, const OBB& b, ObbContact& contact) {
+	return SatTest(MakeSatBox(a), MakeSatBox(b), &contact);
+}
+
+//15軸それぞれでの隙間の最大値(SatTestと同じくaの座標系で計算する)
+static float SatSeparation(const SatBox& a, const SatBox& b) {
+	//平行に近い辺の外積は向きが定まらないので使わない
+	const float kEpsilon = 1.0e-6f;
+
+	float r[3][3];
+	float absR[3][3];
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			r[i][j] = Dot3(a.axes[i], b.axes[j]);
+			absR[i][j] = std::abs(r[i][j]);
+		}
+	}
+	const float d[3] = { b.center[0] - a.center[0],b.center[1] - a.center[1],b.center[2] - a.center[2] };
+	const float t[3] = { Dot3(d, a.axes[0]),Dot3(d, a.axes[1]),Dot3(d, a.axes[2]) };
+	const float* ea = a.halfExtents;
+	const float* eb = b.halfExtents;
+
+	float separation = -std::numeric_limits<float>::infinity();
+	for (int i = 0; i < 3; ++i) {
+		float radius = ea[i] + eb[0] * absR[i][0] + eb[1] * absR[i][1] + eb[2] * absR[i][2];
+		separation = std::max(separation, std::abs(t[i]) - radius);
+	}
+	for (int j = 0; j < 3; ++j) {
+		float radius = ea[0] * absR[0][j] + ea[1] * absR[1][j] + ea[2] * absR[2][j] + eb[j];
+		float distance = t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j];
+		separation = std::max(separation, std::abs(distance) - radius);
+	}
+	for (int i = 0; i < 3; ++i) {
+		int i1 = (i + 1) % 3;
+		int i2 = (i + 2) % 3;
+		for (int j = 0; j < 3; ++j) {
+			float lengthSq = 1.0f - r[i][j] * r[i][j];
+			if (lengthSq <= kEpsilon) {
+				continue;
+			}
+			int j1 = (j + 1) % 3;
+			int j2 = (j + 2) % 3;
+			float radius = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j] + eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+			float distance = t[i2] * r[i1][j] - t[i1] * r[i2][j];
+			//外積は単位ベクトルではないので長さで割って距離にする
+			separation = std::max(separation, (std::abs(distance) - radius) / std::sqrt(lengthSq));
+		}
+	}
+	return separation;
+}
+
+float ObbObbSeparation(const OBB& a, const OBB& b) {
+	return SatSeparation(MakeSatBox(a), MakeSatBox(b));
+}
+
+void ObbObbIsCollisionBatch(const OBBSoAView& obbs, const ObbPair* pairs, size_t pairCount, uint8_t* hits, ObbContact* contacts) {
+	//組はaの順に並んでいることが多いので、同じaなら読み直さない
+	SatBox a{};
+	uint32_t loadedA = UINT32_MAX;
+	for (size_t i = 0; i < pairCount; ++i) {
+		if (pairs[i].a != loadedA) {
+			loadedA = pairs[i].a;
+			a = LoadSatBox(obbs, loadedA);
+		}
+		SatBox b = LoadSatBox(obbs, pairs[i].b);
+		if (contacts) {
+			hits[i] = SatTest(a, b, &contacts[i]) ? 1 : 0;
+		}
+		else {
+			hits[i] = SatTest(a, b, nullptr) ? 1 : 0;
+		}
+	}
+}
+
+void SegmentSoA::PushBack(const Segment& segment) {
+	originX.push_back(segment.origin.x);
+	originY.push_back(segment.origin.y);
+	originZ.push_back(segment.origin.z);
+	diffX.push_back(segment.diff.x);
+	diffY.push_back(segment.diff.y);
+	diffZ.push_back(segment.diff.z);
+}
+
+SegmentSoAView SegmentSoA::View() const {
+	return { originX.data(),originY.data(),originZ.data(),diffX.data(),diffY.data(),diffZ.data(),originX.size() };
+}
+
+void OBBSoA::PushBack(const OBB& obb) {
+	centerX.push_back(obb.center.x);
+	centerY.push_back(obb.center.y);
+	centerZ.push_back(obb.center.z);
+	for (int axis = 0; axis < 3; ++axis) {
+		orientations[axis][0].push_back(obb.orientations[axis].x);
+		orientations[axis][1].push_back(obb.orientations[axis].y);
+		orientations[axis][2].push_back(obb.orientations[axis].z);
+	}
+	sizeX.push_back(obb.size.x);
+	sizeY.push_back(obb.size.y);
+	sizeZ.push_back(obb.size.z);
+}
+
+OBBSoAView OBBSoA::View() const {
+	OBBSoAView view{};
+	view.centerX = centerX.data();
+	view.centerY = centerY.data();
+	view.centerZ = centerZ.data();
+	for (int axis = 0; axis < 3; ++axis) {
+		for (int component = 0; component < 3; ++component) {
+			view.orientations[axis][component] = orientations[axis][component].data();
+		}
+	}
+	view.sizeX = sizeX.data();
+	view.sizeY = sizeY.data();
+	view.sizeZ = sizeZ.data();
+	view.count = centerX.size();
+	return view;
+}
+
+void SegmentSlabSoA::Build(const SegmentSoAView& segments) {
+	originX.assign(segments.originX, segments.originX + segments.count);
+	originY.assign(segments.originY, segments.originY + segments.count);
+	originZ.assign(segments.originZ, segments.originZ + segments.count);
+	invDiffX.resize(segments.count);
+	invDiffY.resize(segments.count);
+	invDiffZ.resize(segments.count);
+	//差分が0の軸は無限大になるが、判定側で平行として扱う
+	for (size_t i = 0; i < segments.count; ++i) {
+		invDiffX[i] = 1.0f / segments.diffX[i];
+		invDiffY[i] = 1.0f / segments.diffY[i];
+		invDiffZ[i] = 1.0f / segments.diffZ[i];
+	}
+}
+
+bool SlabTestInverse(const AABB& aabb, const float origin[3], const float invDiff[3], float tmin, float tmax, float& tEnter) {
+	const float slabMin[3] = { aabb.min.x,aabb.min.y,aabb.min.z };
+	const float slabMax[3] = { aabb.max.x,aabb.max.y,aabb.max.z };
+
+	for (int axis = 0; axis < 3; ++axis) {
+		float tNear;
+		float tFar;
+		if (std::isinf(invDiff[axis])) {
+			bool inside = slabMin[axis] <= origin[axis] && origin[axis] <= slabMax[axis];
+			tNear = inside ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+			tFar = inside ? std::numeric_limits<float>::infinity() : -std::numeric_limits<float>::infinity();
+		}
+		else {
+			float t0 = (slabMin[axis] - origin[axis]) * invDiff[axis];
+			float t1 = (slabMax[axis] - origin[axis]) * invDiff[axis];
+			tNear = std::min(t0, t1);
+			tFar = std::max(t0, t1);
+		}
+		tmin = std::max(tNear, tmin);
+		tmax = std::min(tFar, tmax);
+	}
+	tEnter = tmin;
+	return tmin <= tmax;
+}
+
+//1本分のスラブ判定(逆数版)。SIMD版と同じ演算順にしている
+static bool SlabSegmentScalar(const AABB& aabb, const SegmentSlabSoA& segments, size_t i, float& tEnter) {
+	const float origin[3] = { segments.originX[i],segments.originY[i],segments.originZ[i] };
+	const float invDiff[3] = { segments.invDiffX[i],segments.invDiffY[i],segments.invDiffZ[i] };
+	return SlabTestInverse(aabb, origin, invDiff, 0.0f, 1.0f, tEnter);
+}
+
+static void AabbSegmentIsCollisionBatchScalar(const AABB& aabb, const SegmentSlabSoA& segments, size_t begin, uint8_t* hits, float* tEnters) {
+	for (size_t i = begin; i < segments.Count(); ++i) {
+		float tEnter;
+		if (SlabSegmentScalar(aabb, segments, i, tEnter)) {
+			hits[i] = 1;
+			tEnters[i] = tEnter;
+		}
+		else {
+			hits[i] = 0;
+			tEnters[i] = std::numeric_limits<float>::infinity();
+		}
+	}
+}
+
+#if defined(MT2_SIMD_X86)
+//SSEで4本ずつ判定し、判定できた本数を返す
+static size_t AabbSegmentIsCollisionBatchSSE(const AABB& aabb, const SegmentSlabSoA& segments, uint8_t* hits, float* tEnters) {
+	const float* origin[3] = { segments.originX.data(),segments.originY.data(),segments.originZ.data() };
+	const float* invDiff[3] = { segments.invDiffX.data(),segments.invDiffY.data(),segments.invDiffZ.data() };
+	const __m128 slabMin[3] = { _mm_set1_ps(aabb.min.x),_mm_set1_ps(aabb.min.y),_mm_set1_ps(aabb.min.z) };
+	const __m128 slabMax[3] = { _mm_set1_ps(aabb.max.x),_mm_set1_ps(aabb.max.y),_mm_set1_ps(aabb.max.z) };
+	const __m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+	const __m128 negInf = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 missT = inf;
+
+	size_t count = segments.Count() & ~size_t(3);
+	for (size_t i = 0; i < count; i += 4) {
+		__m128 tmin = _mm_setzero_ps();
+		__m128 tmax = _mm_set1_ps(1.0f);
+		for (int axis = 0; axis < 3; ++axis) {
+			__m128 o = _mm_loadu_ps(origin[axis] + i);
+			__m128 inv = _mm_loadu_ps(invDiff[axis] + i);
+			__m128 t0 = _mm_mul_ps(_mm_sub_ps(slabMin[axis], o), inv);
+			__m128 t1 = _mm_mul_ps(_mm_sub_ps(slabMax[axis], o), inv);
+			__m128 tNear = _mm_min_ps(t0, t1);
+			__m128 tFar = _mm_max_ps(t0, t1);
+			//軸と平行な線分はスラブ内なら(-inf,inf)、外なら空区間
+			__m128 parallel = _mm_cmpeq_ps(_mm_and_ps(inv, absMask), inf);
+			__m128 inside = _mm_and_ps(_mm_cmple_ps(slabMin[axis], o), _mm_cmple_ps(o, slabMax[axis]));
+			__m128 parallelNear = _mm_or_ps(_mm_and_ps(inside, negInf), _mm_andnot_ps(inside, inf));
+			__m128 parallelFar = _mm_or_ps(_mm_and_ps(inside, inf), _mm_andnot_ps(inside, negInf));
+			tNear = _mm_or_ps(_mm_and_ps(parallel, parallelNear), _mm_andnot_ps(parallel, tNear));
+			tFar = _mm_or_ps(_mm_and_ps(parallel, parallelFar), _mm_andnot_ps(parallel, tFar));
+			tmin = _mm_max_ps(tNear, tmin);
+			tmax = _mm_min_ps(tFar, tmax);
+		}
+		__m128 hit = _mm_cmple_ps(tmin, tmax);
+		_mm_storeu_ps(tEnters + i, _mm_or_ps(_mm_and_ps(hit, tmin), _mm_andnot_ps(hit, missT)));
+		int mask = _mm_movemask_ps(hit);
+		for (int lane = 0; lane < 4; ++lane) {
+			hits[i + lane] = uint8_t((mask >> lane) & 1);
+		}
+	}
+	return count;
+}
+
+//AVX2で8本ずつ判定し、判定できた本数を返す
+MT2_TARGET_AVX2 static size_t AabbSegmentIsCollisionBatchAVX2(const AABB& aabb, const SegmentSlabSoA& segments, uint8_t* hits, float* tEnters) {
+	const float* origin[3] = { segments.originX.data(),segments.originY.data(),segments.originZ.data() };
+	const float* invDiff[3] = { segments.invDiffX.data(),segments.invDiffY.data(),segments.invDiffZ.data() };
+	const __m256 slabMin[3] = { _mm256_set1_ps(aabb.min.x),_mm256_set1_ps(aabb.min.y),_mm256_set1_ps(aabb.min.z) };
+	const __m256 slabMax[3] = { _mm256_set1_ps(aabb.max.x),_mm256_set1_ps(aabb.max.y),_mm256_set1_ps(aabb.max.z) };
+	const __m256 inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+	const __m256 negInf = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+	const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+	size_t count = segments.Count() & ~size_t(7);
+	for (size_t i = 0; i < count; i += 8) {
+		__m256 tmin = _mm256_setzero_ps();
+		__m256 tmax = _mm256_set1_ps(1.0f);
+		for (int axis = 0; axis < 3; ++axis) {
+			__m256 o = _mm256_loadu_ps(origin[axis] + i);
+			__m256 inv = _mm256_loadu_ps(invDiff[axis] + i);
+			__m256 t0 = _mm256_mul_ps(_mm256_sub_ps(slabMin[axis], o), inv);
+			__m256 t1 = _mm256_mul_ps(_mm256_sub_ps(slabMax[axis], o), inv);
+			__m256 tNear = _mm256_min_ps(t0, t1);
+			__m256 tFar = _mm256_max_ps(t0, t1);
+			//軸と平行な線分はスラブ内なら(-inf,inf)、外なら空区間
+			__m256 parallel = _mm256_cmp_ps(_mm256_and_ps(inv, absMask), inf, _CMP_EQ_OQ);
+			__m256 inside = _mm256_and_ps(_mm256_cmp_ps(slabMin[axis], o, _CMP_LE_OQ), _mm256_cmp_ps(o, slabMax[axis], _CMP_LE_OQ));
+			__m256 parallelNear = _mm256_blendv_ps(inf, negInf, inside);
+			__m256 parallelFar = _mm256_blendv_ps(negInf, inf, inside);
+			tNear = _mm256_blendv_ps(tNear, parallelNear, parallel);
+			tFar = _mm256_blendv_ps(tFar, parallelFar, parallel);
+			tmin = _mm256_max_ps(tNear, tmin);
+			tmax = _mm256_min_ps(tFar, tmax);
+		}
+		__m256 hit = _mm256_cmp_ps(tmin, tmax, _CMP_LE_OQ);
+		_mm256_storeu_ps(tEnters + i, _mm256_blendv_ps(inf, tmin, hit));
+		int mask = _mm256_movemask_ps(hit);
+		for (int lane = 0; lane < 8; ++lane) {
+			hits[i + lane] = uint8_t((mask >> lane) & 1);
+		}
+	}
+	return count;
+}
+#endif
+
+void AabbSegmentIsCollisionBatch(const AABB& aabb, const SegmentSlabSoA& segments, uint8_t* hits, float* tEnters) {
+	AabbSegmentIsCollisionBatch(aabb, segments, hits, tEnters, GetSimdLevel());
+}
+
+void AabbSegmentIsCollisionBatch(const AABB& aabb, const SegmentSlabSoA& segments, uint8_t* hits, float* tEnters, SimdLevel level) {
+	level = std::min(level, GetSimdLevel());
+	size_t done = 0;
+#if defined(MT2_SIMD_X86)
+	if (level == SimdLevel::kAVX2) {
+		done = AabbSegmentIsCollisionBatchAVX2(aabb, segments, hits, tEnters);
+	}
+	else if (level == SimdLevel::kSSE) {
+		done = AabbSegmentIsCollisionBatchSSE(aabb, segments, hits, tEnters);
+	}
+#endif
+	//端数はスカラーで判定する
+	AabbSegmentIsCollisionBatchScalar(aabb, segments, done, hits, tEnters);
+}
+
+AABB MakeOBBWorldAABB(const OBB& obb) {
+	//各軸方向への広がりは軸ベクトルの成分の絶対値×サイズの和
+	Vector3 extent;
+	extent.x = std::abs(obb.orientations[0].x) * obb.size.x + std::abs(obb.orientations[1].x) * obb.size.y + std::abs(obb.orientations[2].x) * obb.size.z;
+	extent.y = std::abs(obb.orientations[0].y) * obb.size.x + std::abs(obb.orientations[1].y) * obb.size.y + std::abs(obb.orientations[2].y) * obb.size.z;
+	extent.z = std::abs(obb.orientations[0].z) * obb.size.x + std::abs(obb.orientations[1].z) * obb.size.y + std::abs(obb.orientations[2].z) * obb.size.z;
+	return { Subtract(obb.center, extent),Add(obb.center, extent) };
+}
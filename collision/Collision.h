@@ -0,0 +1,148 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "MathFunction.h"
+#include "Simd.h"
+
+class FrameArena;
+
+struct AABB {
+	Vector3 min;
+	Vector3 max;
+};
+
+struct Segment {
+	Vector3 origin;//始点
+	Vector3 diff;//終点への差分ベクトル
+};
+
+struct OBB {
+	Vector3 center;
+	Vector3 orientations[3];
+	Vector3 size;
+};
+
+//線分と箱の交差結果
+struct SegmentHit {
+	float tEnter;//入る時刻(始点が箱の中なら0)
+	float tExit;//出る時刻(終点が箱の中なら1)
+	Vector3 point;//tEnterでのワールド座標
+	Vector3 normal;//入った面のワールド空間の外向き法線(始点が箱の中なら0ベクトル)
+};
+
+//OBB同士の接触(軸はaからbへ向く単位ベクトル、深さはその軸での重なり)
+struct ObbContact {
+	Vector3 axis;
+	float depth;
+};
+
+//OBBの組
+struct ObbPair {
+	uint32_t a;
+	uint32_t b;
+};
+
+//線分の配列(SoA)の参照
+struct SegmentSoAView {
+	const float* originX;
+	const float* originY;
+	const float* originZ;
+	const float* diffX;
+	const float* diffY;
+	const float* diffZ;
+	size_t count;
+};
+
+//OBBの配列(SoA)の参照
+struct OBBSoAView {
+	const float* centerX;
+	const float* centerY;
+	const float* centerZ;
+	const float* orientations[3][3];//[軸][成分]
+	const float* sizeX;
+	const float* sizeY;
+	const float* sizeZ;
+	size_t count;
+};
+
+//線分の配列(SoA)
+struct SegmentSoA {
+	std::vector<float> originX;
+	std::vector<float> originY;
+	std::vector<float> originZ;
+	std::vector<float> diffX;
+	std::vector<float> diffY;
+	std::vector<float> diffZ;
+
+	void PushBack(const Segment& segment);
+	SegmentSoAView View() const;
+};
+
+//OBBの配列(SoA)
+struct OBBSoA {
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> orientations[3][3];//[軸][成分]
+	std::vector<float> sizeX;
+	std::vector<float> sizeY;
+	std::vector<float> sizeZ;
+
+	void PushBack(const OBB& obb);
+	OBBSoAView View() const;
+};
+
+//スラブ判定用に方向の逆数を前計算した線分配列(SoA)
+struct SegmentSlabSoA {
+	std::vector<float> originX;
+	std::vector<float> originY;
+	std::vector<float> originZ;
+	std::vector<float> invDiffX;
+	std::vector<float> invDiffY;
+	std::vector<float> invDiffZ;
+
+	void Build(const SegmentSoAView& segments);
+	size_t Count() const { return originX.size(); }
+};
+
+bool ObbSegmentIsCollision(const Segment& segment, const OBB& obb);
+bool AabbSegmentIsCollision(const AABB& aabb, const Segment& segment);
+//AABBと線分の交差区間(tmin,tmax)を求める
+bool AabbSegmentIntersect(const AABB& aabb, const Segment& segment, float& tmin, float& tmax);
+//AABBと線分の交差区間と入った点・面の法線を求める
+bool AabbSegmentIntersect(const AABB& aabb, const Segment& segment, SegmentHit& hit);
+//OBBと線分の交差区間と入った点・面の法線を求める
+bool ObbSegmentIntersect(const Segment& segment, const OBB& obb, SegmentHit& hit);
+//方向の逆数を使うスラブ判定。[tmin,tmax]の範囲で当たっていればtEnterを返す
+bool SlabTestInverse(const AABB& aabb, const float origin[3], const float invDiff[3], float tmin, float tmax, float& tEnter);
+//OBBのワールド行列
+Matrix4x4 MakeOBBWorldMatrix(const OBB& obb);
+//OBBを囲むワールド空間のAABB
+AABB MakeOBBWorldAABB(const OBB& obb);
+//OBBのローカル空間での線分との判定(逆行列は呼び出し側で用意する)
+bool ObbSegmentIntersectLocal(const Segment& segment, const OBB& obb, const Matrix4x4& obbWorldMatrixInverse, float& tmin);
+//交差結果を返す版(点と法線はOBBの軸から求めるので逆行列は1つで済む)
+bool ObbSegmentIntersectLocal(const Segment& segment, const OBB& obb, const Matrix4x4& obbWorldMatrixInverse, SegmentHit& hit);
+//OBB同士の分離軸判定(分離軸が見つかった時点で打ち切る)
+bool ObbObbIsCollision(const OBB& a, const OBB& b);
+//当たっていれば重なりが最も浅い軸と深さを返す
+bool ObbObbIntersect(const OBB& a, const OBB& b, ObbContact& contact);
+//SoAから取り出す
+Segment GetSegment(const SegmentSoAView& segments, size_t index);
+OBB GetOBB(const OBBSoAView& obbs, size_t index);
+//線分とOBBの総当たり判定(結果は[segment * obbs.count + obb]の順に格納)
+//localObbsとinversesはOBBごとの前計算を置く作業領域(obbs.count個以上)
+void ObbSegmentIsCollisionBatch(const SegmentSoAView& segments, const OBBSoAView& obbs, uint8_t* hitMasks, float* tEnters,
+	std::span<OBB> localObbs, std::span<Matrix4x4> inverses);
+//作業領域をarenaから取る版(フレームごとに呼んでもヒープから確保しない)
+void ObbSegmentIsCollisionBatch(const SegmentSoAView& segments, const OBBSoAView& obbs, uint8_t* hitMasks, float* tEnters, FrameArena& arena);
+//分離軸判定の15軸での隙間の最大値(離れていれば正で、OBB同士の距離以下になる。重なっていれば0以下)
+float ObbObbSeparation(const OBB& a, const OBB& b);
+//OBBの組ごとの分離軸判定(contactsはnullptrでもよい)
+void ObbObbIsCollisionBatch(const OBBSoAView& obbs, const ObbPair* pairs, size_t pairCount, uint8_t* hits, ObbContact* contacts);
+//1つのAABBと複数の線分の判定(SSE/AVX2で4本/8本ずつ判定する)
+void AabbSegmentIsCollisionBatch(const AABB& aabb, const SegmentSlabSoA& segments, uint8_t* hits, float* tEnters);
+//使用するSIMD命令を指定する版(未対応の命令は使える中で最も近いものになる)
+void AabbSegmentIsCollisionBatch(const AABB& aabb, const SegmentSlabSoA& segments, uint8_t* hits, float* tEnters, SimdLevel level);
@@ -0,0 +1,66 @@
+#include "Frustum.h"
+#include <cmath>
+
+//同次座標の1次式 a・(x,y,z,1) >= 0 を正規化した平面にする
+static Plane MakePlane(float a, float b, float c, float d) {
+	float length = std::sqrt(a * a + b * b + c * c);
+	float inverseLength = length > 0.0f ? 1.0f / length : 0.0f;
+	return { { a * inverseLength,b * inverseLength,c * inverseLength },d * inverseLength };
+}
+
+Frustum MakeFrustum(const Matrix4x4& viewProjectionMatrix) {
+	//行ベクトルなのでクリップ座標の各成分は行列の列との内積になる
+	const Matrix4x4& m = viewProjectionMatrix;
+	auto Column = [&](int column, int row) { return m.m[row][column]; };
+
+	Frustum frustum;
+	//-w <= x
+	frustum.planes[0] = MakePlane(Column(3, 0) + Column(0, 0), Column(3, 1) + Column(0, 1), Column(3, 2) + Column(0, 2), Column(3, 3) + Column(0, 3));
+	//x <= w
+	frustum.planes[1] = MakePlane(Column(3, 0) - Column(0, 0), Column(3, 1) - Column(0, 1), Column(3, 2) - Column(0, 2), Column(3, 3) - Column(0, 3));
+	//-w <= y
+	frustum.planes[2] = MakePlane(Column(3, 0) + Column(1, 0), Column(3, 1) + Column(1, 1), Column(3, 2) + Column(1, 2), Column(3, 3) + Column(1, 3));
+	//y <= w
+	frustum.planes[3] = MakePlane(Column(3, 0) - Column(1, 0), Column(3, 1) - Column(1, 1), Column(3, 2) - Column(1, 2), Column(3, 3) - Column(1, 3));
+	//0 <= z
+	frustum.planes[4] = MakePlane(Column(2, 0), Column(2, 1), Column(2, 2), Column(2, 3));
+	//z <= w
+	frustum.planes[5] = MakePlane(Column(3, 0) - Column(2, 0), Column(3, 1) - Column(2, 1), Column(3, 2) - Column(2, 2), Column(3, 3) - Column(2, 3));
+	return frustum;
+}
+
+bool IsOBBVisible(const Frustum& frustum, const OBB& obb) {
+	for (const Plane& plane : frustum.planes) {
+		//平面の法線方向へのOBBの広がり
+		float radius =
+			std::abs(Dot(plane.normal, obb.orientations[0])) * obb.size.x +
+			std::abs(Dot(plane.normal, obb.orientations[1])) * obb.size.y +
+			std::abs(Dot(plane.normal, obb.orientations[2])) * obb.size.z;
+		if (Dot(plane.normal, obb.center) + plane.distance < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t CullOBBs(const Frustum& frustum, const OBBSoAView& obbs, uint8_t* visible) {
+	//OBBの方向にループを回してSoAのまま連続に読む(平面は定数として展開される)
+	for (size_t i = 0; i < obbs.count; ++i) {
+		bool inside = true;
+		for (const Plane& plane : frustum.planes) {
+			const Vector3& n = plane.normal;
+			float radius =
+				std::abs(n.x * obbs.orientations[0][0][i] + n.y * obbs.orientations[0][1][i] + n.z * obbs.orientations[0][2][i]) * obbs.sizeX[i] +
+				std::abs(n.x * obbs.orientations[1][0][i] + n.y * obbs.orientations[1][1][i] + n.z * obbs.orientations[1][2][i]) * obbs.sizeY[i] +
+				std::abs(n.x * obbs.orientations[2][0][i] + n.y * obbs.orientations[2][1][i] + n.z * obbs.orientations[2][2][i]) * obbs.sizeZ[i];
+			float distance = n.x * obbs.centerX[i] + n.y * obbs.centerY[i] + n.z * obbs.centerZ[i] + plane.distance;
+			inside = inside && distance >= -radius;
+		}
+		visible[i] = inside ? 1 : 0;
+	}
+	size_t visibleCount = 0;
+	for (size_t i = 0; i < obbs.count; ++i) {
+		visibleCount += visible[i];
+	}
+	return visibleCount;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Collision.h"
+#include "MathFunction.h"
+
+//平面(Dot(normal, p) + distance >= 0 の側を内側とする。normalは単位ベクトル)
+struct Plane {
+	Vector3 normal;
+	float distance;
+};
+
+//視錐台(左、右、下、上、近、遠の順)
+struct Frustum {
+	Plane planes[6];
+};
+
+//ビュープロジェクション行列から視錐台の6平面を取り出す(クリップ空間のzは0～w)
+Frustum MakeFrustum(const Matrix4x4& viewProjectionMatrix);
+//OBBが視錐台と重なる可能性があるか(完全に外側の平面が1つでもあればfalse)
+bool IsOBBVisible(const Frustum& frustum, const OBB& obb);
+//OBBごとに見えるなら1、見えないなら0をvisibleに書き込み、見える数を返す
+size_t CullOBBs(const Frustum& frustum, const OBBSoAView& obbs, uint8_t* visible);
@@ -0,0 +1,65 @@
+#include "InverseBenchmark.h"
+#include <chrono>
+#include <random>
+#include <vector>
+#include "Collision.h"
+
+//全ての要素の和(1要素だけ返すと残りの要素の計算が最適化で消えてしまう)
+static float SumElements(const Matrix4x4& m) {
+	float sum = 0.0f;
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 4; ++column) {
+			sum += m.m[row][column];
+		}
+	}
+	return sum;
+}
+
+InverseBenchmarkResult BenchmarkInverse(uint32_t iterations) {
+	//同じ入力で比べられるように乱数の種は固定する
+	const uint32_t kInputCount = 256;
+	std::mt19937 random(12345);
+	std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::vector<Matrix4x4> matrices(kInputCount);
+	std::vector<OBB> obbs(kInputCount);
+	std::vector<Segment> segments(kInputCount);
+	for (uint32_t i = 0; i < kInputCount; ++i) {
+		matrices[i] = MakeAffineMatrix({ 1.0f,1.0f,1.0f }, { angle(random),angle(random),angle(random) }, { position(random),position(random),position(random) });
+		obbs[i].center = { matrices[i].m[3][0],matrices[i].m[3][1],matrices[i].m[3][2] };
+		for (int axis = 0; axis < 3; ++axis) {
+			obbs[i].orientations[axis] = { matrices[i].m[axis][0],matrices[i].m[axis][1],matrices[i].m[axis][2] };
+		}
+		obbs[i].size = { 1.0f,1.0f,1.0f };
+		segments[i] = { { position(random),position(random),position(random) },{ position(random),position(random),position(random) } };
+	}
+
+	//最適化で計算が消えないように結果を足し込む
+	volatile float sink = 0.0f;
+	auto measure = [&](auto&& body) {
+		auto start = std::chrono::steady_clock::now();
+		float sum = 0.0f;
+		for (uint32_t i = 0; i < iterations; ++i) {
+			sum += body(i % kInputCount);
+		}
+		auto end = std::chrono::steady_clock::now();
+		sink = sink + sum;
+		return std::chrono::duration<double, std::nano>(end - start).count() / double(iterations);
+	};
+
+	InverseBenchmarkResult result{};
+	result.inverseNs = measure([&](uint32_t i) { return SumElements(Inverse(matrices[i])); });
+	result.inverseAffineNs = measure([&](uint32_t i) { return SumElements(InverseAffine(matrices[i])); });
+	result.inverseRigidNs = measure([&](uint32_t i) { return SumElements(InverseRigid(matrices[i])); });
+	result.obbQueryInverseNs = measure([&](uint32_t i) {
+		float tmin = 0.0f;
+		ObbSegmentIntersectLocal(segments[i], obbs[i], Inverse(MakeOBBWorldMatrix(obbs[i])), tmin);
+		return tmin;
+		});
+	result.obbQueryRigidNs = measure([&](uint32_t i) {
+		float tmin = 0.0f;
+		ObbSegmentIntersectLocal(segments[i], obbs[i], InverseRigid(MakeOBBWorldMatrix(obbs[i])), tmin);
+		return tmin;
+		});
+	return result;
+}
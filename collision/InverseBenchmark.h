@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+
+//逆行列の計測結果(1回あたりのナノ秒)
+struct InverseBenchmarkResult {
+	double inverseNs;
+	double inverseAffineNs;
+	double inverseRigidNs;
+	double obbQueryInverseNs;//逆行列にInverseを使ったOBBと線分の判定
+	double obbQueryRigidNs;//逆行列にInverseRigidを使ったOBBと線分の判定
+};
+
+//Inverse/InverseAffine/InverseRigidの速度を比べる
+InverseBenchmarkResult BenchmarkInverse(uint32_t iterations);
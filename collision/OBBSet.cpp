@@ -0,0 +1,190 @@
+#include "OBBSet.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+//1本のfloat配列の要素数はこの倍数にする(64バイト)
+static const size_t kStreamGranularity = OBBSet::kStreamAlignment / sizeof(float);
+
+//ストリームの並び
+static const size_t kCenterStream = 0;
+static const size_t kOrientationStream = 3;//[軸 * 3 + 成分]
+static const size_t kSizeStream = 12;
+
+void OBBSet::AlignedDelete::operator()(float* block) const {
+	::operator delete[](block, std::align_val_t(kStreamAlignment));
+}
+
+void OBBSet::Grow(size_t capacity) {
+	capacity = (capacity + kStreamGranularity - 1) / kStreamGranularity * kStreamGranularity;
+	size_t floatCount = capacity * kStreamCount;
+	std::unique_ptr<float[], AlignedDelete> streams(static_cast<float*>(::operator new[](floatCount * sizeof(float), std::align_val_t(kStreamAlignment))));
+	std::memset(streams.get(), 0, floatCount * sizeof(float));
+	for (size_t stream = 0; stream < kStreamCount && count_ != 0; ++stream) {
+		std::memcpy(streams.get() + stream * capacity, GetStream(stream), count_ * sizeof(float));
+	}
+	streams_ = std::move(streams);
+	capacity_ = capacity;
+}
+
+void OBBSet::Reserve(size_t capacity) {
+	if (capacity > capacity_) {
+		Grow(capacity);
+	}
+	handles_.reserve(capacity);
+	metadata_.reserve(capacity);
+}
+
+void OBBSet::Write(size_t index, const OBB& obb) {
+	GetStream(kCenterStream + 0)[index] = obb.center.x;
+	GetStream(kCenterStream + 1)[index] = obb.center.y;
+	GetStream(kCenterStream + 2)[index] = obb.center.z;
+	for (size_t axis = 0; axis < 3; ++axis) {
+		GetStream(kOrientationStream + axis * 3 + 0)[index] = obb.orientations[axis].x;
+		GetStream(kOrientationStream + axis * 3 + 1)[index] = obb.orientations[axis].y;
+		GetStream(kOrientationStream + axis * 3 + 2)[index] = obb.orientations[axis].z;
+	}
+	GetStream(kSizeStream + 0)[index] = obb.size.x;
+	GetStream(kSizeStream + 1)[index] = obb.size.y;
+	GetStream(kSizeStream + 2)[index] = obb.size.z;
+}
+
+OBBHandle OBBSet::Add(const OBB& obb, const OBBMetadata& metadata) {
+	if (count_ == capacity_) {
+		Grow(std::max(capacity_ * 2, kStreamGranularity));
+	}
+	uint32_t slot;
+	if (freeSlot_ != UINT32_MAX) {
+		slot = freeSlot_;
+		freeSlot_ = slots_[slot].index;
+	}
+	else {
+		slot = uint32_t(slots_.size());
+		slots_.push_back({ 0,0 });
+	}
+	size_t index = count_++;
+	slots_[slot].index = uint32_t(index);
+	Write(index, obb);
+	OBBHandle handle = { slot,slots_[slot].generation };
+	handles_.push_back(handle);
+	metadata_.push_back(metadata);
+	return handle;
+}
+
+bool OBBSet::Remove(OBBHandle handle) {
+	if (!IsValid(handle)) {
+		return false;
+	}
+	size_t index = slots_[handle.slot].index;
+	size_t last = count_ - 1;
+	//末尾の要素を空いた位置に移す
+	if (index != last) {
+		for (size_t stream = 0; stream < kStreamCount; ++stream) {
+			float* values = GetStream(stream);
+			values[index] = values[last];
+		}
+		handles_[index] = handles_[last];
+		metadata_[index] = metadata_[last];
+		slots_[handles_[index].slot].index = uint32_t(index);
+	}
+	for (size_t stream = 0; stream < kStreamCount; ++stream) {
+		GetStream(stream)[last] = 0.0f;
+	}
+	handles_.pop_back();
+	metadata_.pop_back();
+	--count_;
+
+	//世代を進めて空きスロットにつなぐ
+	++slots_[handle.slot].generation;
+	slots_[handle.slot].index = freeSlot_;
+	freeSlot_ = handle.slot;
+	return true;
+}
+
+void OBBSet::Clear() {
+	for (size_t index = 0; index < count_; ++index) {
+		Slot& slot = slots_[handles_[index].slot];
+		++slot.generation;
+		slot.index = freeSlot_;
+		freeSlot_ = handles_[index].slot;
+	}
+	for (size_t stream = 0; stream < kStreamCount && count_ != 0; ++stream) {
+		std::memset(GetStream(stream), 0, count_ * sizeof(float));
+	}
+	handles_.clear();
+	metadata_.clear();
+	count_ = 0;
+}
+
+bool OBBSet::IsValid(OBBHandle handle) const {
+	if (handle.slot >= slots_.size()) {
+		return false;
+	}
+	const Slot& slot = slots_[handle.slot];
+	return slot.generation == handle.generation && slot.index < count_ && handles_[slot.index] == handle;
+}
+
+size_t OBBSet::GetIndex(OBBHandle handle) const {
+	return IsValid(handle) ? slots_[handle.slot].index : SIZE_MAX;
+}
+
+OBB OBBSet::Get(OBBHandle handle) const {
+	assert(IsValid(handle));
+	return GetOBB(View(), slots_[handle.slot].index);
+}
+
+void OBBSet::Set(OBBHandle handle, const OBB& obb) {
+	assert(IsValid(handle));
+	Write(slots_[handle.slot].index, obb);
+}
+
+OBBMetadata& OBBSet::GetMetadata(OBBHandle handle) {
+	assert(IsValid(handle));
+	return metadata_[slots_[handle.slot].index];
+}
+
+const OBBMetadata& OBBSet::GetMetadata(OBBHandle handle) const {
+	assert(IsValid(handle));
+	return metadata_[slots_[handle.slot].index];
+}
+
+OBBSoAView OBBSet::View() const {
+	OBBSoAView view{};
+	if (capacity_ == 0) {
+		return view;
+	}
+	view.centerX = GetStream(kCenterStream + 0);
+	view.centerY = GetStream(kCenterStream + 1);
+	view.centerZ = GetStream(kCenterStream + 2);
+	for (size_t axis = 0; axis < 3; ++axis) {
+		for (size_t component = 0; component < 3; ++component) {
+			view.orientations[axis][component] = GetStream(kOrientationStream + axis * 3 + component);
+		}
+	}
+	view.sizeX = GetStream(kSizeStream + 0);
+	view.sizeY = GetStream(kSizeStream + 1);
+	view.sizeZ = GetStream(kSizeStream + 2);
+	view.count = count_;
+	return view;
+}
+
+OBBSoAMutableView OBBSet::MutableView() {
+	OBBSoAMutableView view{};
+	if (capacity_ == 0) {
+		return view;
+	}
+	view.centerX = GetStream(kCenterStream + 0);
+	view.centerY = GetStream(kCenterStream + 1);
+	view.centerZ = GetStream(kCenterStream + 2);
+	for (size_t axis = 0; axis < 3; ++axis) {
+		for (size_t component = 0; component < 3; ++component) {
+			view.orientations[axis][component] = GetStream(kOrientationStream + axis * 3 + component);
+		}
+	}
+	view.sizeX = GetStream(kSizeStream + 0);
+	view.sizeY = GetStream(kSizeStream + 1);
+	view.sizeZ = GetStream(kSizeStream + 2);
+	view.count = count_;
+	return view;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Collision.h"
+
+//OBBSetの要素を指すハンドル(要素を消すと世代が進み、古いハンドルは無効になる)
+struct OBBHandle {
+	uint32_t slot;
+	uint32_t generation;
+};
+
+inline bool operator==(const OBBHandle& lhs, const OBBHandle& rhs) {
+	return lhs.slot == rhs.slot && lhs.generation == rhs.generation;
+}
+
+static const OBBHandle kInvalidOBBHandle = { UINT32_MAX,0 };
+
+//判定では使わない付随情報
+struct OBBMetadata {
+	uint32_t color;
+	uint32_t userData;
+};
+
+//OBBの配列(SoA)の書き換え用の参照
+struct OBBSoAMutableView {
+	float* centerX;
+	float* centerY;
+	float* centerZ;
+	float* orientations[3][3];//[軸][成分]
+	float* sizeX;
+	float* sizeY;
+	float* sizeZ;
+	size_t count;
+};
+
+//多数のOBBを持つ入れ物
+//判定で読む中心・軸・大きさは15本のfloat配列として64バイト境界に並べ、付随情報とハンドルは別の配列に分ける
+//要素は詰めて並べるので、消すときは末尾の要素を空いた位置に移す(順番は保たない)
+//配列の末尾は64バイト単位まで0で埋めるので、SIMDで端数を気にせず読んでよい
+class OBBSet {
+public:
+	OBBSet() = default;
+	OBBSet(const OBBSet&) = delete;
+	OBBSet& operator=(const OBBSet&) = delete;
+
+	OBBHandle Add(const OBB& obb, const OBBMetadata& metadata = {});
+	//無効なハンドルならfalse
+	bool Remove(OBBHandle handle);
+	void Clear();
+	void Reserve(size_t capacity);
+
+	bool IsValid(OBBHandle handle) const;
+	//ハンドルの要素が今ある位置(View()の添え字)。無効ならSIZE_MAX
+	size_t GetIndex(OBBHandle handle) const;
+	//位置からハンドルを引く(判定結果の添え字を戻すとき用)
+	OBBHandle GetHandle(size_t index) const { return handles_[index]; }
+
+	OBB Get(OBBHandle handle) const;
+	void Set(OBBHandle handle, const OBB& obb);
+	OBBMetadata& GetMetadata(OBBHandle handle);
+	const OBBMetadata& GetMetadata(OBBHandle handle) const;
+
+	size_t Count() const { return count_; }
+	size_t GetCapacity() const { return capacity_; }
+
+	//コピーせずに判定や描画へ渡す(要素を足す・消すまで有効)
+	OBBSoAView View() const;
+	OBBSoAMutableView MutableView();
+
+	static constexpr size_t kStreamAlignment = 64;
+	static constexpr size_t kStreamCount = 15;
+
+private:
+	struct AlignedDelete {
+		void operator()(float* block) const;
+	};
+	struct Slot {
+		uint32_t index;//空きスロットなら次の空きスロット
+		uint32_t generation;
+	};
+
+	float* GetStream(size_t stream) const { return streams_.get() + stream * capacity_; }
+	void Grow(size_t capacity);
+	void Write(size_t index, const OBB& obb);
+
+	std::unique_ptr<float[], AlignedDelete> streams_;
+	size_t count_ = 0;
+	size_t capacity_ = 0;//1本あたりの要素数(64バイト単位)
+
+	std::vector<OBBHandle> handles_;//位置からハンドル
+	std::vector<OBBMetadata> metadata_;
+	std::vector<Slot> slots_;
+	uint32_t freeSlot_ = UINT32_MAX;
+};
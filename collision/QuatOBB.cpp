@@ -0,0 +1,132 @@
+#include "QuatOBB.h"
+#include <cassert>
+#include "Profiler.h"
+
+QuatOBB MakeQuatOBB(const Vector3& center, const Vector3& rotate, const Vector3& halfExtents) {
+	return { center,MakeRotateXYZQuaternion(rotate),halfExtents };
+}
+
+OBB ToOBB(const QuatOBB& obb) {
+	OBB result;
+	result.center = obb.center;
+	MakeRotateAxes(obb.rotation, result.orientations);
+	result.size = obb.halfExtents;
+	return result;
+}
+
+void QuatOBBSoA::PushBack(const QuatOBB& obb) {
+	centerX.push_back(obb.center.x);
+	centerY.push_back(obb.center.y);
+	centerZ.push_back(obb.center.z);
+	rotationX.push_back(obb.rotation.x);
+	rotationY.push_back(obb.rotation.y);
+	rotationZ.push_back(obb.rotation.z);
+	rotationW.push_back(obb.rotation.w);
+	halfExtentX.push_back(obb.halfExtents.x);
+	halfExtentY.push_back(obb.halfExtents.y);
+	halfExtentZ.push_back(obb.halfExtents.z);
+}
+
+QuatOBB QuatOBBSoA::Get(size_t index) const {
+	return {
+		{ centerX[index],centerY[index],centerZ[index] },
+		{ rotationX[index],rotationY[index],rotationZ[index],rotationW[index] },
+		{ halfExtentX[index],halfExtentY[index],halfExtentZ[index] },
+	};
+}
+
+void ApplyDeltaRotations(QuatOBBSoA& obbs, std::span<const Quaternion> deltas) {
+	MT2_PROFILE_SCOPE("ApplyDeltaRotations");
+	assert(deltas.size() == obbs.Count());
+	float* x = obbs.rotationX.data();
+	float* y = obbs.rotationY.data();
+	float* z = obbs.rotationZ.data();
+	float* w = obbs.rotationW.data();
+	for (size_t i = 0; i < deltas.size(); ++i) {
+		Quaternion rotated = Multiply(deltas[i], { x[i],y[i],z[i],w[i] });
+		x[i] = rotated.x;
+		y[i] = rotated.y;
+		z[i] = rotated.z;
+		w[i] = rotated.w;
+	}
+}
+
+void ApplyDeltaRotation(QuatOBBSoA& obbs, const Quaternion& delta) {
+	MT2_PROFILE_SCOPE("ApplyDeltaRotation");
+	float* x = obbs.rotationX.data();
+	float* y = obbs.rotationY.data();
+	float* z = obbs.rotationZ.data();
+	float* w = obbs.rotationW.data();
+	//deltaが共通なので積を展開して配列ごとに回す(ベクトル化しやすい)
+	const size_t count = obbs.Count();
+	for (size_t i = 0; i < count; ++i) {
+		float qx = x[i];
+		float qy = y[i];
+		float qz = z[i];
+		float qw = w[i];
+		x[i] = delta.w * qx + delta.x * qw + delta.y * qz - delta.z * qy;
+		y[i] = delta.w * qy - delta.x * qz + delta.y * qw + delta.z * qx;
+		z[i] = delta.w * qz + delta.x * qy - delta.y * qx + delta.z * qw;
+		w[i] = delta.w * qw - delta.x * qx - delta.y * qy - delta.z * qz;
+	}
+}
+
+void RenormalizeQuaternions(QuatOBBSoA& obbs) {
+	MT2_PROFILE_SCOPE("RenormalizeQuaternions");
+	float* x = obbs.rotationX.data();
+	float* y = obbs.rotationY.data();
+	float* z = obbs.rotationZ.data();
+	float* w = obbs.rotationW.data();
+	const size_t count = obbs.Count();
+	for (size_t i = 0; i < count; ++i) {
+		float lengthSq = x[i] * x[i] + y[i] * y[i] + z[i] * z[i] + w[i] * w[i];
+		float scale = (3.0f - lengthSq) * 0.5f;
+		x[i] *= scale;
+		y[i] *= scale;
+		z[i] *= scale;
+		w[i] *= scale;
+	}
+}
+
+void ExpandQuatOBBs(const QuatOBBSoA& obbs, OBBSoA& out) {
+	MT2_PROFILE_SCOPE("ExpandQuatOBBs");
+	const size_t count = obbs.Count();
+	out.centerX.assign(obbs.centerX.begin(), obbs.centerX.end());
+	out.centerY.assign(obbs.centerY.begin(), obbs.centerY.end());
+	out.centerZ.assign(obbs.centerZ.begin(), obbs.centerZ.end());
+	out.sizeX.assign(obbs.halfExtentX.begin(), obbs.halfExtentX.end());
+	out.sizeY.assign(obbs.halfExtentY.begin(), obbs.halfExtentY.end());
+	out.sizeZ.assign(obbs.halfExtentZ.begin(), obbs.halfExtentZ.end());
+	float* axes[3][3];
+	for (int axis = 0; axis < 3; ++axis) {
+		for (int component = 0; component < 3; ++component) {
+			out.orientations[axis][component].resize(count);
+			axes[axis][component] = out.orientations[axis][component].data();
+		}
+	}
+	const float* x = obbs.rotationX.data();
+	const float* y = obbs.rotationY.data();
+	const float* z = obbs.rotationZ.data();
+	const float* w = obbs.rotationW.data();
+	//MakeRotateAxesと同じ式を配列ごとに回す
+	for (size_t i = 0; i < count; ++i) {
+		float xx = x[i] * x[i];
+		float yy = y[i] * y[i];
+		float zz = z[i] * z[i];
+		float xy = x[i] * y[i];
+		float xz = x[i] * z[i];
+		float yz = y[i] * z[i];
+		float wx = w[i] * x[i];
+		float wy = w[i] * y[i];
+		float wz = w[i] * z[i];
+		axes[0][0][i] = 1.0f - 2.0f * (yy + zz);
+		axes[0][1][i] = 2.0f * (xy + wz);
+		axes[0][2][i] = 2.0f * (xz - wy);
+		axes[1][0][i] = 2.0f * (xy - wz);
+		axes[1][1][i] = 1.0f - 2.0f * (xx + zz);
+		axes[1][2][i] = 2.0f * (yz + wx);
+		axes[2][0][i] = 2.0f * (xz + wy);
+		axes[2][1][i] = 2.0f * (yz - wx);
+		axes[2][2][i] = 1.0f - 2.0f * (xx + yy);
+	}
+}
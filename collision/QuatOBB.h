@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "Collision.h"
+#include "Quaternion.h"
+
+//向きをクォータニオンで持つOBB(OBBの15floatに対して10float)
+struct QuatOBB {
+	Vector3 center;
+	Quaternion rotation;
+	Vector3 halfExtents;
+};
+
+//オイラー角(MakeRotateXYZMatrixと同じ順)から作る
+QuatOBB MakeQuatOBB(const Vector3& center, const Vector3& rotate, const Vector3& halfExtents);
+//軸を展開したOBBにする
+OBB ToOBB(const QuatOBB& obb);
+
+//QuatOBBの配列(SoA)
+struct QuatOBBSoA {
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> rotationX;
+	std::vector<float> rotationY;
+	std::vector<float> rotationZ;
+	std::vector<float> rotationW;
+	std::vector<float> halfExtentX;
+	std::vector<float> halfExtentY;
+	std::vector<float> halfExtentZ;
+
+	void PushBack(const QuatOBB& obb);
+	size_t Count() const { return centerX.size(); }
+	QuatOBB Get(size_t index) const;
+};
+
+//各OBBの向きにdeltasの回転を重ねる(deltasはOBBと同じ数。三角関数は使わない)
+void ApplyDeltaRotations(QuatOBBSoA& obbs, std::span<const Quaternion> deltas);
+//全てのOBBに同じ回転を重ねる
+void ApplyDeltaRotation(QuatOBBSoA& obbs, const Quaternion& delta);
+//回転を重ねてずれた長さを1に戻す
+//長さが1に近い前提でsqrtを使わずにニュートン法1回で近似する(q *= (3 - |q|^2) / 2)
+void RenormalizeQuaternions(QuatOBBSoA& obbs);
+//軸を展開してOBBSoAに書き出す(outの要素数はobbsに合わせる)
+void ExpandQuatOBBs(const QuatOBBSoA& obbs, OBBSoA& out);
@@ -0,0 +1,141 @@
+#include "SegmentQueryScheduler.h"
+#include <algorithm>
+#include "Profiler.h"
+
+template<typename Hit>
+void SegmentQueryScheduler::PrepareChunks(size_t count, std::vector<std::vector<Hit>>& chunkHits) {
+	size_t chunkCount = (count + chunkSize_ - 1) / chunkSize_;
+	//前回の容量は残しておく
+	if (chunkHits.size() < chunkCount) {
+		chunkHits.resize(chunkCount);
+	}
+	for (size_t i = 0; i < chunkCount; ++i) {
+		chunkHits[i].clear();
+	}
+	chunkOffsets_.assign(chunkCount + 1, 0);
+}
+
+template<typename Hit>
+void SegmentQueryScheduler::GatherHits(std::vector<std::vector<Hit>>& chunkHits, std::vector<Hit>& hits) {
+	size_t chunkCount = chunkOffsets_.size() - 1;
+	for (size_t i = 0; i < chunkCount; ++i) {
+		chunkOffsets_[i + 1] = chunkOffsets_[i] + chunkHits[i].size();
+	}
+	hits.resize(chunkOffsets_[chunkCount]);
+	//書き込み先が決まっているのでコピーも分けて行える
+	pool_.ParallelFor(chunkCount, 16, [&](size_t begin, size_t end, uint32_t) {
+		for (size_t i = begin; i < end; ++i) {
+			std::copy(chunkHits[i].begin(), chunkHits[i].end(), hits.begin() + chunkOffsets_[i]);
+		}
+		});
+}
+
+SegmentQueryScheduler::SegmentQueryScheduler(ThreadPool& pool, uint32_t chunkSize)
+	: pool_(pool), chunkSize_(chunkSize > 0 ? chunkSize : 1) {
+	scratch_.resize(pool_.GetWorkerCount());
+}
+
+void SegmentQueryScheduler::Query(const SegmentSoAView& segments, const OBBBVH& bvh, std::vector<SegmentObbHit>& hits) {
+	MT2_PROFILE_SCOPE("SegmentQueryScheduler::Query");
+	PrepareChunks(segments.count, chunkHits_);
+	pool_.ParallelFor(segments.count, chunkSize_, [&](size_t begin, size_t end, uint32_t workerIndex) {
+		WorkerScratch& scratch = scratch_[workerIndex];
+		std::vector<SegmentObbHit>& out = chunkHits_[begin / chunkSize_];
+		for (size_t i = begin; i < end; ++i) {
+			bvh.QuerySegment(GetSegment(segments, i), scratch.hitIndices, scratch.hitTs);
+			//BVHを辿った順ではなくOBBの番号順にそろえる
+			scratch.segmentHits.clear();
+			for (size_t hit = 0; hit < scratch.hitIndices.size(); ++hit) {
+				scratch.segmentHits.push_back({ uint32_t(i),scratch.hitIndices[hit],scratch.hitTs[hit] });
+			}
+			std::sort(scratch.segmentHits.begin(), scratch.segmentHits.end(), [](const SegmentObbHit& a, const SegmentObbHit& b) {
+				return a.obbIndex < b.obbIndex;
+				});
+			out.insert(out.end(), scratch.segmentHits.begin(), scratch.segmentHits.end());
+		}
+		});
+	GatherHits(chunkHits_, hits);
+}
+
+void SegmentQueryScheduler::Query(const SegmentSoAView& segments, const OBBSoAView& obbs, std::vector<SegmentObbHit>& hits) {
+	MT2_PROFILE_SCOPE("SegmentQueryScheduler::Query");
+	//OBBごとの逆行列とワールドAABBは1回だけ作る
+	obbs_.resize(obbs.count);
+	inverses_.resize(obbs.count);
+	bounds_.resize(obbs.count);
+	for (size_t i = 0; i < obbs.count; ++i) {
+		obbs_[i] = GetOBB(obbs, i);
+		inverses_[i] = InverseRigid(MakeOBBWorldMatrix(obbs_[i]));
+		bounds_[i] = MakeOBBWorldAABB(obbs_[i]);
+	}
+
+	PrepareChunks(segments.count, chunkHits_);
+	pool_.ParallelFor(segments.count, chunkSize_, [&](size_t begin, size_t end, uint32_t) {
+		std::vector<SegmentObbHit>& out = chunkHits_[begin / chunkSize_];
+		for (size_t i = begin; i < end; ++i) {
+			Segment segment = GetSegment(segments, i);
+			const float origin[3] = { segment.origin.x,segment.origin.y,segment.origin.z };
+			const float invDiff[3] = { 1.0f / segment.diff.x,1.0f / segment.diff.y,1.0f / segment.diff.z };
+			for (size_t obb = 0; obb < obbs_.size(); ++obb) {
+				float tEnter;
+				if (!SlabTestInverse(bounds_[obb], origin, invDiff, 0.0f, 1.0f, tEnter)) {
+					continue;
+				}
+				float tmin;
+				if (ObbSegmentIntersectLocal(segment, obbs_[obb], inverses_[obb], tmin)) {
+					out.push_back({ uint32_t(i),uint32_t(obb),tmin });
+				}
+			}
+		}
+		});
+	GatherHits(chunkHits_, hits);
+}
+
+void SegmentQueryScheduler::QueryOverlaps(const OBBSoAView& obbs, const OBBBVH& bvh, std::vector<ObbPairHit>& hits) {
+	MT2_PROFILE_SCOPE("SegmentQueryScheduler::QueryOverlaps");
+	PrepareChunks(obbs.count, chunkPairHits_);
+	pool_.ParallelFor(obbs.count, chunkSize_, [&](size_t begin, size_t end, uint32_t workerIndex) {
+		WorkerScratch& scratch = scratch_[workerIndex];
+		std::vector<ObbPairHit>& out = chunkPairHits_[begin / chunkSize_];
+		for (size_t i = begin; i < end; ++i) {
+			bvh.QueryAABB(MakeOBBWorldAABB(GetOBB(obbs, i)), scratch.hitIndices);
+			//同じ組を2回数えないように自分より後ろの番号だけを番号順に見る
+			scratch.pairs.clear();
+			for (uint32_t other : scratch.hitIndices) {
+				if (other > i) {
+					scratch.pairs.push_back({ uint32_t(i),other });
+				}
+			}
+			std::sort(scratch.pairs.begin(), scratch.pairs.end(), [](const ObbPair& a, const ObbPair& b) {
+				return a.b < b.b;
+				});
+			scratch.pairHits.resize(scratch.pairs.size());
+			scratch.contacts.resize(scratch.pairs.size());
+			ObbObbIsCollisionBatch(obbs, scratch.pairs.data(), scratch.pairs.size(), scratch.pairHits.data(), scratch.contacts.data());
+			AppendPairHits(scratch, out);
+		}
+		});
+	GatherHits(chunkPairHits_, hits);
+}
+
+void SegmentQueryScheduler::QueryOverlaps(const OBBSoAView& obbs, const std::vector<ObbPair>& pairs, std::vector<ObbPairHit>& hits) {
+	MT2_PROFILE_SCOPE("SegmentQueryScheduler::QueryOverlaps");
+	PrepareChunks(pairs.size(), chunkPairHits_);
+	pool_.ParallelFor(pairs.size(), chunkSize_, [&](size_t begin, size_t end, uint32_t workerIndex) {
+		WorkerScratch& scratch = scratch_[workerIndex];
+		scratch.pairs.assign(pairs.begin() + begin, pairs.begin() + end);
+		scratch.pairHits.resize(scratch.pairs.size());
+		scratch.contacts.resize(scratch.pairs.size());
+		ObbObbIsCollisionBatch(obbs, scratch.pairs.data(), scratch.pairs.size(), scratch.pairHits.data(), scratch.contacts.data());
+		AppendPairHits(scratch, chunkPairHits_[begin / chunkSize_]);
+		});
+	GatherHits(chunkPairHits_, hits);
+}
+
+void SegmentQueryScheduler::AppendPairHits(const WorkerScratch& scratch, std::vector<ObbPairHit>& out) {
+	for (size_t i = 0; i < scratch.pairs.size(); ++i) {
+		if (scratch.pairHits[i]) {
+			out.push_back({ scratch.pairs[i].a,scratch.pairs[i].b,scratch.contacts[i] });
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "BVH.h"
+#include "Collision.h"
+#include "ThreadPool.h"
+
+//線分とOBBのヒット
+struct SegmentObbHit {
+	uint32_t segmentIndex;
+	uint32_t obbIndex;
+	float t;//進入時刻
+};
+
+//OBB同士のヒット
+struct ObbPairHit {
+	uint32_t a;//a < b
+	uint32_t b;
+	ObbContact contact;
+};
+
+//大量の線分とOBBの判定をスレッドプールで分けて行う
+//結果はスレッド数に関係なく(線分の番号, OBBの番号)の順に並ぶ
+class SegmentQueryScheduler {
+public:
+	explicit SegmentQueryScheduler(ThreadPool& pool, uint32_t chunkSize = 256);
+
+	//BVHで候補を絞ってから判定する
+	void Query(const SegmentSoAView& segments, const OBBBVH& bvh, std::vector<SegmentObbHit>& hits);
+	//全てのOBBについてワールドAABBで弾いてから判定する
+	void Query(const SegmentSoAView& segments, const OBBSoAView& obbs, std::vector<SegmentObbHit>& hits);
+
+	//BVHで重なる組を作り、分離軸判定で当たっている組を(a, b)の順に集める
+	//obbsはbvhを構築した時と同じであること
+	void QueryOverlaps(const OBBSoAView& obbs, const OBBBVH& bvh, std::vector<ObbPairHit>& hits);
+	//組が決まっている場合(sweep and pruneなど)は分離軸判定だけを分けて行う
+	void QueryOverlaps(const OBBSoAView& obbs, const std::vector<ObbPair>& pairs, std::vector<ObbPairHit>& hits);
+
+	void SetChunkSize(uint32_t chunkSize) { chunkSize_ = chunkSize > 0 ? chunkSize : 1; }
+	uint32_t GetChunkSize() const { return chunkSize_; }
+
+private:
+	//ワーカーごとの作業領域
+	struct WorkerScratch {
+		std::vector<uint32_t> hitIndices;
+		std::vector<float> hitTs;
+		std::vector<SegmentObbHit> segmentHits;
+		std::vector<ObbPair> pairs;
+		std::vector<uint8_t> pairHits;
+		std::vector<ObbContact> contacts;
+	};
+
+	template<typename Hit>
+	void PrepareChunks(size_t count, std::vector<std::vector<Hit>>& chunkHits);
+	//チャンクごとの結果を番号順に連結する
+	template<typename Hit>
+	void GatherHits(std::vector<std::vector<Hit>>& chunkHits, std::vector<Hit>& hits);
+	//組ごとの判定結果のうち当たった組をチャンクの結果に足す
+	static void AppendPairHits(const WorkerScratch& scratch, std::vector<ObbPairHit>& out);
+
+	ThreadPool& pool_;
+	uint32_t chunkSize_;
+	std::vector<std::vector<SegmentObbHit>> chunkHits_;
+	std::vector<std::vector<ObbPairHit>> chunkPairHits_;
+	std::vector<size_t> chunkOffsets_;
+	std::vector<WorkerScratch> scratch_;
+	std::vector<OBB> obbs_;
+	std::vector<Matrix4x4> inverses_;
+	std::vector<AABB> bounds_;
+};
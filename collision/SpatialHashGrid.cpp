@@ -0,0 +1,255 @@
+#include "SpatialHashGrid.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "Profiler.h"
+
+static uint32_t HashCell(int32_t x, int32_t y, int32_t z) {
+	return uint32_t(x) * 73856093u ^ uint32_t(y) * 19349663u ^ uint32_t(z) * 83492791u;
+}
+
+SpatialHashGrid::SpatialHashGrid(float cellSize) {
+	SetCellSize(cellSize);
+}
+
+void SpatialHashGrid::SetCellSize(float cellSize) {
+	assert(cellSize > 0.0f);
+	cellSize_ = cellSize;
+	inverseCellSize_ = 1.0f / cellSize;
+}
+
+SpatialHashGrid::CellRange SpatialHashGrid::GetCellRange(const AABB& bounds) const {
+	CellRange range;
+	const float boundsMin[3] = { bounds.min.x,bounds.min.y,bounds.min.z };
+	const float boundsMax[3] = { bounds.max.x,bounds.max.y,bounds.max.z };
+	for (int axis = 0; axis < 3; ++axis) {
+		range.min[axis] = int32_t(std::floor(boundsMin[axis] * inverseCellSize_));
+		range.max[axis] = int32_t(std::floor(boundsMax[axis] * inverseCellSize_));
+	}
+	return range;
+}
+
+SpatialHashGrid::Cell& SpatialHashGrid::FindOrInsert(int32_t x, int32_t y, int32_t z) {
+	size_t mask = cells_.size() - 1;
+	for (size_t slot = HashCell(x, y, z) & mask;; slot = (slot + 1) & mask) {
+		Cell& cell = cells_[slot];
+		if (cell.count == 0) {
+			cell.x = x;
+			cell.y = y;
+			cell.z = z;
+			++cellCount_;
+			return cell;
+		}
+		if (cell.x == x && cell.y == y && cell.z == z) {
+			return cell;
+		}
+	}
+}
+
+const SpatialHashGrid::Cell* SpatialHashGrid::Find(int32_t x, int32_t y, int32_t z) const {
+	size_t mask = cells_.size() - 1;
+	for (size_t slot = HashCell(x, y, z) & mask;; slot = (slot + 1) & mask) {
+		const Cell& cell = cells_[slot];
+		if (cell.count == 0) {
+			return nullptr;
+		}
+		if (cell.x == x && cell.y == y && cell.z == z) {
+			return &cell;
+		}
+	}
+}
+
+void SpatialHashGrid::Build(const OBBSoAView& obbs) {
+	MT2_PROFILE_SCOPE("SpatialHashGrid::Build");
+	obbs_.resize(obbs.count);
+	inverses_.resize(obbs.count);
+	bounds_.resize(obbs.count);
+	mailbox_.assign(obbs.count, 0);
+	epoch_ = 0;
+	cellCount_ = 0;
+	items_.clear();
+	cells_.clear();
+	if (obbs.count == 0) {
+		return;
+	}
+
+	const float inf = std::numeric_limits<float>::infinity();
+	gridBounds_ = { { inf,inf,inf },{ -inf,-inf,-inf } };
+	size_t touchCount = 0;
+	for (size_t i = 0; i < obbs.count; ++i) {
+		obbs_[i] = GetOBB(obbs, i);
+		inverses_[i] = InverseRigid(MakeOBBWorldMatrix(obbs_[i]));
+		bounds_[i] = MakeOBBWorldAABB(obbs_[i]);
+		gridBounds_.min = { std::min(gridBounds_.min.x, bounds_[i].min.x),std::min(gridBounds_.min.y, bounds_[i].min.y),std::min(gridBounds_.min.z, bounds_[i].min.z) };
+		gridBounds_.max = { std::max(gridBounds_.max.x, bounds_[i].max.x),std::max(gridBounds_.max.y, bounds_[i].max.y),std::max(gridBounds_.max.z, bounds_[i].max.z) };
+		CellRange range = GetCellRange(bounds_[i]);
+		touchCount += size_t(range.max[0] - range.min[0] + 1) * size_t(range.max[1] - range.min[1] + 1) * size_t(range.max[2] - range.min[2] + 1);
+	}
+	gridRange_ = GetCellRange(gridBounds_);
+
+	//使うセルの数は登録回数以下なので、その2倍以上の2のべき乗にしておけば表が埋まらない
+	size_t capacity = 16;
+	while (capacity < touchCount * 2) {
+		capacity *= 2;
+	}
+	cells_.assign(capacity, Cell{ 0,0,0,0,0 });
+
+	//1回目: セルごとの数を数える
+	for (size_t i = 0; i < obbs.count; ++i) {
+		CellRange range = GetCellRange(bounds_[i]);
+		for (int32_t z = range.min[2]; z <= range.max[2]; ++z) {
+			for (int32_t y = range.min[1]; y <= range.max[1]; ++y) {
+				for (int32_t x = range.min[0]; x <= range.max[0]; ++x) {
+					++FindOrInsert(x, y, z).count;
+				}
+			}
+		}
+	}
+	//累積和で各セルの終端を決める
+	uint32_t offset = 0;
+	for (Cell& cell : cells_) {
+		offset += cell.count;
+		cell.begin = offset;
+	}
+	items_.resize(offset);
+	//2回目: 後ろの番号から終端側に詰めていく(セルの中は番号順になり、beginは先頭を指して終わる)
+	for (size_t i = obbs.count; i-- > 0;) {
+		CellRange range = GetCellRange(bounds_[i]);
+		for (int32_t z = range.min[2]; z <= range.max[2]; ++z) {
+			for (int32_t y = range.min[1]; y <= range.max[1]; ++y) {
+				for (int32_t x = range.min[0]; x <= range.max[0]; ++x) {
+					items_[--FindOrInsert(x, y, z).begin] = uint32_t(i);
+				}
+			}
+		}
+	}
+}
+
+template<typename Visitor>
+void SpatialHashGrid::WalkSegment(const Segment& segment, Visitor&& visitor) const {
+	if (cells_.empty()) {
+		return;
+	}
+	//グリッド全体の範囲に切り詰めてから歩く
+	float tBegin;
+	float tEnd;
+	if (!AabbSegmentIntersect(gridBounds_, segment, tBegin, tEnd)) {
+		return;
+	}
+
+	const float inf = std::numeric_limits<float>::infinity();
+	const float origin[3] = { segment.origin.x,segment.origin.y,segment.origin.z };
+	const float diff[3] = { segment.diff.x,segment.diff.y,segment.diff.z };
+	int32_t cell[3];
+	int32_t step[3];
+	float tMax[3];
+	float tDelta[3];
+	for (int axis = 0; axis < 3; ++axis) {
+		float start = origin[axis] + diff[axis] * tBegin;
+		cell[axis] = std::clamp(int32_t(std::floor(start * inverseCellSize_)), gridRange_.min[axis], gridRange_.max[axis]);
+		if (diff[axis] == 0.0f) {
+			step[axis] = 0;
+			tMax[axis] = inf;
+			tDelta[axis] = inf;
+		}
+		else {
+			step[axis] = diff[axis] > 0.0f ? 1 : -1;
+			float boundary = float(cell[axis] + (step[axis] > 0 ? 1 : 0)) * cellSize_;
+			tMax[axis] = (boundary - origin[axis]) / diff[axis];
+			tDelta[axis] = cellSize_ / std::abs(diff[axis]);
+		}
+	}
+
+	while (true) {
+		//次に越える境界の軸
+		int axis = 0;
+		if (tMax[1] < tMax[axis]) {
+			axis = 1;
+		}
+		if (tMax[2] < tMax[axis]) {
+			axis = 2;
+		}
+		const Cell* found = Find(cell[0], cell[1], cell[2]);
+		if (found && !visitor(*found, tMax[axis])) {
+			return;
+		}
+		if (tMax[axis] > tEnd) {
+			return;
+		}
+		cell[axis] += step[axis];
+		if (cell[axis] < gridRange_.min[axis] || gridRange_.max[axis] < cell[axis]) {
+			return;
+		}
+		tMax[axis] += tDelta[axis];
+	}
+}
+
+bool SpatialHashGrid::TestObb(const Segment& segment, uint32_t obbIndex, float& tmin) {
+	if (mailbox_[obbIndex] == epoch_) {
+		return false;
+	}
+	mailbox_[obbIndex] = epoch_;
+	++testCount_;
+	return ObbSegmentIntersectLocal(segment, obbs_[obbIndex], inverses_[obbIndex], tmin);
+}
+
+void SpatialHashGrid::QuerySegment(const Segment& segment, std::vector<uint32_t>& hitIndices, std::vector<float>& hitTs) {
+	hitIndices.clear();
+	hitTs.clear();
+	hits_.clear();
+	testCount_ = 0;
+	//問い合わせの番号が一周したら印を消す
+	if (++epoch_ == 0) {
+		std::fill(mailbox_.begin(), mailbox_.end(), 0u);
+		epoch_ = 1;
+	}
+
+	WalkSegment(segment, [&](const Cell& cell, float) {
+		for (uint32_t i = 0; i < cell.count; ++i) {
+			uint32_t obbIndex = items_[cell.begin + i];
+			float tmin;
+			if (TestObb(segment, obbIndex, tmin)) {
+				hits_.push_back({ obbIndex,tmin });
+			}
+		}
+		return true;
+		});
+
+	//セルを通った順ではなく番号順にそろえる(印があるので同じ番号は無い)
+	std::sort(hits_.begin(), hits_.end(), [](const Hit& a, const Hit& b) { return a.index < b.index; });
+	hitIndices.reserve(hits_.size());
+	hitTs.reserve(hits_.size());
+	for (const Hit& hit : hits_) {
+		hitIndices.push_back(hit.index);
+		hitTs.push_back(hit.t);
+	}
+}
+
+bool SpatialHashGrid::ClosestHit(const Segment& segment, uint32_t& hitIndex, float& hitT) {
+	testCount_ = 0;
+	if (++epoch_ == 0) {
+		std::fill(mailbox_.begin(), mailbox_.end(), 0u);
+		epoch_ = 1;
+	}
+
+	bool found = false;
+	float bestT = 1.0f;
+	WalkSegment(segment, [&](const Cell& cell, float tCellExit) {
+		for (uint32_t i = 0; i < cell.count; ++i) {
+			uint32_t obbIndex = items_[cell.begin + i];
+			float tmin;
+			if (TestObb(segment, obbIndex, tmin) && (!found || tmin < bestT)) {
+				found = true;
+				bestT = tmin;
+				hitIndex = obbIndex;
+			}
+		}
+		//まだ調べていないOBBはこのセルより奥でしか当たらない
+		return !(found && bestT <= tCellExit);
+		});
+	if (found) {
+		hitT = bestT;
+	}
+	return found;
+}
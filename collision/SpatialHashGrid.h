@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Collision.h"
+
+//一様なセルに分けたハッシュグリッド
+//OBBはワールドAABBが掛かるセル全てに登録し、線分は3D DDAで通るセルだけを調べる
+//セルの表は開番地法の1本の配列で、セルごとの要素も1本の配列にまとめて持つ
+class SpatialHashGrid {
+public:
+	explicit SpatialHashGrid(float cellSize = 1.0f);
+
+	//次のBuildから有効になる
+	void SetCellSize(float cellSize);
+	float GetCellSize() const { return cellSize_; }
+
+	void Build(const OBBSoAView& obbs);
+	//線分と当たる全てのOBBの番号と進入時刻を集める(番号順)
+	//同じOBBを2回調べないための印を書き換えるので、同時に複数のスレッドからは呼べない
+	void QuerySegment(const Segment& segment, std::vector<uint32_t>& hitIndices, std::vector<float>& hitTs);
+	//線分と最初に当たるOBBを求める(手前のセルから順に調べ、当たった時点で打ち切る)
+	bool ClosestHit(const Segment& segment, uint32_t& hitIndex, float& hitT);
+
+	//使っているセルの数
+	size_t GetCellCount() const { return cellCount_; }
+	//直前の問い合わせで判定したOBBの数
+	uint32_t GetTestCount() const { return testCount_; }
+
+private:
+	//開番地法の表の1要素(countが0なら空き)
+	struct Cell {
+		int32_t x;
+		int32_t y;
+		int32_t z;
+		uint32_t begin;//items_の中の位置
+		uint32_t count;
+	};
+
+	//QuerySegmentで集めた当たり
+	struct Hit {
+		uint32_t index;
+		float t;
+	};
+
+	//セルの座標の範囲
+	struct CellRange {
+		int32_t min[3];
+		int32_t max[3];
+	};
+
+	CellRange GetCellRange(const AABB& bounds) const;
+	//無ければ追加する
+	Cell& FindOrInsert(int32_t x, int32_t y, int32_t z);
+	const Cell* Find(int32_t x, int32_t y, int32_t z) const;
+	//線分が通るセルを手前から順にvisitor(セル)で調べる。falseを返したら打ち切る
+	template<typename Visitor>
+	void WalkSegment(const Segment& segment, Visitor&& visitor) const;
+	//印が付いていなければ付けて判定する
+	bool TestObb(const Segment& segment, uint32_t obbIndex, float& tmin);
+
+	float cellSize_;
+	float inverseCellSize_;
+	std::vector<Cell> cells_;//大きさは2のべき乗
+	size_t cellCount_ = 0;
+	std::vector<uint32_t> items_;
+	AABB gridBounds_{};
+	CellRange gridRange_{};
+
+	std::vector<OBB> obbs_;
+	std::vector<Matrix4x4> inverses_;
+	std::vector<AABB> bounds_;
+	std::vector<uint32_t> mailbox_;//OBBごとに最後に調べた問い合わせの番号
+	uint32_t epoch_ = 0;
+	uint32_t testCount_ = 0;
+	std::vector<Hit> hits_;//QuerySegmentの作業領域(番号順に並べ替える)
+};
@@ -0,0 +1,177 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+#include "Profiler.h"
+
+static float AxisValue(const Vector3& v, int axis) {
+	return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+//同じ値なら最小側を先にして、接しているだけの組も重なりとして扱う
+static bool EndpointLess(float valueA, uint32_t dataA, float valueB, uint32_t dataB) {
+	if (valueA != valueB) {
+		return valueA < valueB;
+	}
+	return (dataA & 1) < (dataB & 1);
+}
+
+//端点の並べ方と同じく、接しているだけでも重なりとして扱う
+static bool IsOverlapping(const AABB& a, const AABB& b) {
+	//挿入ソートの中で結果がばらばらに変わるので、分岐せずに全ての比較をまとめる
+	return (a.min.x <= b.max.x) & (b.min.x <= a.max.x) & (a.min.y <= b.max.y) & (b.min.y <= a.max.y) & (a.min.z <= b.max.z) & (b.min.z <= a.max.z);
+}
+
+//組を引くためのキー(小さい番号を上位に置く)
+static uint64_t MakePairKey(uint32_t a, uint32_t b) {
+	return (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+}
+
+void SweepAndPrune::Build(const OBBSoAView& obbs) {
+	MT2_PROFILE_SCOPE("SweepAndPrune::Build");
+	UpdateBounds(obbs);
+
+	//中心が最もばらついている軸で並べると重なる区間が少ない
+	float mean[3] = {};
+	float meanSq[3] = {};
+	for (const AABB& bounds : bounds_) {
+		for (int axis = 0; axis < 3; ++axis) {
+			float center = (AxisValue(bounds.min, axis) + AxisValue(bounds.max, axis)) * 0.5f;
+			mean[axis] += center;
+			meanSq[axis] += center * center;
+		}
+	}
+	float bestVariance = -1.0f;
+	for (int axis = 0; axis < 3; ++axis) {
+		float count = float(std::max<size_t>(bounds_.size(), 1));
+		float variance = meanSq[axis] / count - (mean[axis] / count) * (mean[axis] / count);
+		if (variance > bestVariance) {
+			bestVariance = variance;
+			axis_ = axis;
+		}
+	}
+
+	for (int axis = 0; axis < 3; ++axis) {
+		std::vector<Endpoint>& endpoints = endpoints_[axis];
+		endpoints.resize(bounds_.size() * 2);
+		for (uint32_t i = 0; i < uint32_t(bounds_.size()); ++i) {
+			endpoints[i * 2] = { AxisValue(bounds_[i].min, axis),i * 2 };
+			endpoints[i * 2 + 1] = { AxisValue(bounds_[i].max, axis),i * 2 + 1 };
+		}
+		std::sort(endpoints.begin(), endpoints.end(), [](const Endpoint& a, const Endpoint& b) {
+			return EndpointLess(a.value, a.data, b.value, b.data);
+			});
+	}
+	swapCount_ = 0;
+	Sweep();
+}
+
+void SweepAndPrune::Update(const OBBSoAView& obbs) {
+	MT2_PROFILE_SCOPE("SweepAndPrune::Update");
+	if (obbs.count * 2 != endpoints_[0].size()) {
+		Build(obbs);
+		return;
+	}
+	//組は前回のAABBで重なっていたものなので、離れたかどうかを調べる前に残しておく
+	previousBounds_.swap(bounds_);
+	UpdateBounds(obbs);
+	swapCount_ = 0;
+	for (int axis = 0; axis < 3; ++axis) {
+		for (Endpoint& endpoint : endpoints_[axis]) {
+			const AABB& bounds = bounds_[endpoint.data >> 1];
+			endpoint.value = AxisValue((endpoint.data & 1) ? bounds.max : bounds.min, axis);
+		}
+		SortEndpoints(axis);
+	}
+}
+
+void SweepAndPrune::UpdateBounds(const OBBSoAView& obbs) {
+	bounds_.resize(obbs.count);
+	for (size_t i = 0; i < obbs.count; ++i) {
+		bounds_[i] = MakeOBBWorldAABB(GetOBB(obbs, i));
+	}
+}
+
+void SweepAndPrune::SortEndpoints(int axis) {
+	//前のフレームとほとんど同じ並びなので挿入ソートが速い
+	//入れ替わるのは前後関係が変わった端点の組だけなので、重なりが変わった組はここで全て見つかる
+	std::vector<Endpoint>& endpoints = endpoints_[axis];
+	for (size_t i = 1; i < endpoints.size(); ++i) {
+		Endpoint key = endpoints[i];
+		size_t j = i;
+		while (j > 0 && EndpointLess(key.value, key.data, endpoints[j - 1].value, endpoints[j - 1].data)) {
+			const uint32_t passed = endpoints[j - 1].data;
+			//最小側と最大側が入れ替わったときだけこの軸の重なりが変わる
+			if ((key.data & 1) != (passed & 1)) {
+				if (key.data & 1) {
+					//最大側が相手の最小側より前に出たので離れた(前回重なっていなければ組は無い)
+					if (IsOverlapping(previousBounds_[key.data >> 1], previousBounds_[passed >> 1])) {
+						RemovePair(key.data >> 1, passed >> 1);
+					}
+				}
+				else if (IsOverlapping(bounds_[key.data >> 1], bounds_[passed >> 1])) {
+					//この軸で重なり始め、残りの軸でも重なっている
+					AddPair(key.data >> 1, passed >> 1);
+				}
+			}
+			endpoints[j] = endpoints[j - 1];
+			--j;
+		}
+		swapCount_ += i - j;
+		endpoints[j] = key;
+	}
+}
+
+void SweepAndPrune::Sweep() {
+	pairs_.clear();
+	pairSlots_.clear();
+	active_.clear();
+	activeSlots_.resize(bounds_.size());
+	const int otherAxis0 = (axis_ + 1) % 3;
+	const int otherAxis1 = (axis_ + 2) % 3;
+
+	for (const Endpoint& endpoint : endpoints_[axis_]) {
+		uint32_t box = endpoint.data >> 1;
+		if (endpoint.data & 1) {
+			//区間が終わったので入れ替えて取り除く
+			uint32_t slot = activeSlots_[box];
+			active_[slot] = active_.back();
+			activeSlots_[active_[slot]] = slot;
+			active_.pop_back();
+			continue;
+		}
+
+		//並べた軸では重なっているので残りの2軸だけ調べる
+		const AABB& bounds = bounds_[box];
+		for (uint32_t other : active_) {
+			const AABB& otherBounds = bounds_[other];
+			if (AxisValue(bounds.min, otherAxis0) <= AxisValue(otherBounds.max, otherAxis0) && AxisValue(otherBounds.min, otherAxis0) <= AxisValue(bounds.max, otherAxis0) &&
+				AxisValue(bounds.min, otherAxis1) <= AxisValue(otherBounds.max, otherAxis1) && AxisValue(otherBounds.min, otherAxis1) <= AxisValue(bounds.max, otherAxis1)) {
+				AddPair(box, other);
+			}
+		}
+		activeSlots_[box] = uint32_t(active_.size());
+		active_.push_back(box);
+	}
+}
+
+void SweepAndPrune::AddPair(uint32_t a, uint32_t b) {
+	//複数の軸で同時に重なり始めた組は2回目以降は何もしない
+	if (pairSlots_.try_emplace(MakePairKey(a, b), uint32_t(pairs_.size())).second) {
+		pairs_.push_back({ std::min(a, b),std::max(a, b) });
+	}
+}
+
+void SweepAndPrune::RemovePair(uint32_t a, uint32_t b) {
+	//別の軸で先に取り除いた場合もある
+	auto found = pairSlots_.find(MakePairKey(a, b));
+	if (found == pairSlots_.end()) {
+		return;
+	}
+	//末尾の組を空いた位置に移す
+	uint32_t slot = found->second;
+	pairSlots_.erase(found);
+	if (slot + 1 != pairs_.size()) {
+		pairs_[slot] = pairs_.back();
+		pairSlots_[MakePairKey(pairs_[slot].a, pairs_[slot].b)] = slot;
+	}
+	pairs_.pop_back();
+}
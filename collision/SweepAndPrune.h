@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Collision.h"
+
+//OBBのワールドAABBを3軸それぞれに並べた端点で重なる組を探す
+//端点の並びと重なっている組はフレームをまたいで残し、挿入ソートで並べ直すときに
+//最小側と最大側の端点が入れ替わった組だけを足し引きするので
+//ほとんど動かない場面ではOBBの数と入れ替わりの数にほぼ比例した時間で済む
+class SweepAndPrune {
+public:
+	//端点を一から並べ直し、組を作り直す
+	void Build(const OBBSoAView& obbs);
+	//前回の並びと組を使って更新する(OBBの数が変わった場合はBuildする)
+	void Update(const OBBSoAView& obbs);
+
+	//AABBが重なっている組(a < b)。組の並びは決まっていない
+	const std::vector<ObbPair>& GetPairs() const { return pairs_; }
+	//直前の更新で挿入ソートが入れ替えた回数(3軸の合計)
+	uint64_t GetSwapCount() const { return swapCount_; }
+	//Buildで組を作るときに掃引した軸
+	int GetAxis() const { return axis_; }
+
+private:
+	//端点(dataは箱の番号 * 2 + 最大側なら1)
+	struct Endpoint {
+		float value;
+		uint32_t data;
+	};
+
+	void UpdateBounds(const OBBSoAView& obbs);
+	void SortEndpoints(int axis);
+	void Sweep();
+	void AddPair(uint32_t a, uint32_t b);
+	void RemovePair(uint32_t a, uint32_t b);
+
+	int axis_ = 0;
+	std::vector<AABB> bounds_;
+	std::vector<AABB> previousBounds_;//Updateの前のbounds_
+	std::vector<Endpoint> endpoints_[3];
+	std::vector<uint32_t> active_;
+	std::vector<uint32_t> activeSlots_;//箱ごとのactive_の中の位置
+	std::vector<ObbPair> pairs_;
+	std::unordered_map<uint64_t, uint32_t> pairSlots_;//組ごとのpairs_の中の位置
+	uint64_t swapCount_ = 0;
+};
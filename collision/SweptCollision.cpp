@@ -0,0 +1,156 @@
+#include "SweptCollision.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Profiler.h"
+
+//動く範囲と、表面の点が時刻1あたりに動く距離の上限
+struct SweepBound {
+	AABB aabb;
+	float motion;
+};
+
+static SweepBound MakeSweepBound(const SweptOBB& obb) {
+	const Vector3& c0 = obb.start.center;
+	const Vector3& c1 = obb.end.center;
+	float angle = GetRotationAngle(obb.start.rotation, obb.end.rotation);
+	float radius = Length(obb.size);
+
+	SweepBound bound;
+	//回っている点の速さは角速度×中心からの距離以下
+	bound.motion = Length(Subtract(c1, c0)) + angle * radius;
+	if (angle == 0.0f) {
+		//平行移動だけなら両端のAABBを合わせたものに収まる
+		AABB startAabb = MakeOBBWorldAABB(GetSweptOBBAt(obb, 0.0f));
+		AABB endAabb = MakeOBBWorldAABB(GetSweptOBBAt(obb, 1.0f));
+		bound.aabb.min = { std::min(startAabb.min.x, endAabb.min.x),std::min(startAabb.min.y, endAabb.min.y),std::min(startAabb.min.z, endAabb.min.z) };
+		bound.aabb.max = { std::max(startAabb.max.x, endAabb.max.x),std::max(startAabb.max.y, endAabb.max.y),std::max(startAabb.max.z, endAabb.max.z) };
+	}
+	else {
+		//回転の途中は外接球で囲む
+		bound.aabb.min = { std::min(c0.x, c1.x) - radius,std::min(c0.y, c1.y) - radius,std::min(c0.z, c1.z) - radius };
+		bound.aabb.max = { std::max(c0.x, c1.x) + radius,std::max(c0.y, c1.y) + radius,std::max(c0.z, c1.z) + radius };
+	}
+	return bound;
+}
+
+static bool OverlapAABB(const AABB& a, const AABB& b) {
+	return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+		a.min.y <= b.max.y && a.max.y >= b.min.y &&
+		a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+//線分を厚さ0のOBBとして扱う(分離軸判定の軸が足りるように直交する軸を作る)
+static OBB MakeSegmentOBB(const Segment& segment) {
+	OBB obb{};
+	obb.center = Add(segment.origin, Multiply(0.5f, segment.diff));
+	float length = Length(segment.diff);
+	if (length == 0.0f) {
+		obb.orientations[0] = { 1.0f,0.0f,0.0f };
+		obb.orientations[1] = { 0.0f,1.0f,0.0f };
+		obb.orientations[2] = { 0.0f,0.0f,1.0f };
+		return obb;
+	}
+	Vector3 direction = Multiply(1.0f / length, segment.diff);
+	Vector3 other = std::abs(direction.x) < 0.9f ? Vector3{ 1.0f,0.0f,0.0f } : Vector3{ 0.0f,1.0f,0.0f };
+	obb.orientations[0] = direction;
+	obb.orientations[1] = Normalize(Cross(direction, other));
+	obb.orientations[2] = Cross(direction, obb.orientations[1]);
+	obb.size = { length * 0.5f,0.0f,0.0f };
+	return obb;
+}
+
+//保守的前進: 分離軸での隙間は距離以下なので、隙間/速さの上限だけ進めても突き抜けない
+//bが止まっているならboundBのmotionは0
+template<typename GetB>
+static bool AdvanceToImpact(const SweptOBB& a, float motion, GetB&& getB, float& toi) {
+	float t = 0.0f;
+	for (uint32_t iteration = 0; iteration < kTimeOfImpactMaxIterations; ++iteration) {
+		float separation = ObbObbSeparation(GetSweptOBBAt(a, t), getB(t));
+		if (separation <= kTimeOfImpactTolerance) {
+			toi = t;
+			return true;
+		}
+		if (motion <= 0.0f) {
+			return false;
+		}
+		t += separation / motion;
+		if (t > 1.0f) {
+			return false;
+		}
+	}
+	//反復が足りなければ当たったとみなす(見逃すよりは早めに止める)
+	toi = t;
+	return true;
+}
+
+OBB GetSweptOBBAt(const SweptOBB& obb, float t) {
+	OBB result;
+	result.center = {
+		obb.start.center.x + (obb.end.center.x - obb.start.center.x) * t,
+		obb.start.center.y + (obb.end.center.y - obb.start.center.y) * t,
+		obb.start.center.z + (obb.end.center.z - obb.start.center.z) * t,
+	};
+	MakeRotateAxes(Slerp(obb.start.rotation, obb.end.rotation, t), result.orientations);
+	result.size = obb.size;
+	return result;
+}
+
+AABB MakeSweptOBBAABB(const SweptOBB& obb) {
+	return MakeSweepBound(obb).aabb;
+}
+
+static bool SegmentTimeOfImpact(const SweptOBB& obb, const SweepBound& bound, const Segment& segment, const OBB& segmentObb, float& toi) {
+	if (!AabbSegmentIsCollision(bound.aabb, segment)) {
+		return false;
+	}
+	return AdvanceToImpact(obb, bound.motion, [&](float) { return segmentObb; }, toi);
+}
+
+static bool ObbTimeOfImpact(const SweptOBB& a, const SweepBound& boundA, const SweptOBB& b, const SweepBound& boundB, float& toi) {
+	if (!OverlapAABB(boundA.aabb, boundB.aabb)) {
+		return false;
+	}
+	//近づく速さの上限は2つの上限の和
+	return AdvanceToImpact(a, boundA.motion + boundB.motion, [&](float t) { return GetSweptOBBAt(b, t); }, toi);
+}
+
+bool SweptObbSegmentTimeOfImpact(const SweptOBB& obb, const Segment& segment, float& toi) {
+	return SegmentTimeOfImpact(obb, MakeSweepBound(obb), segment, MakeSegmentOBB(segment), toi);
+}
+
+bool SweptObbObbTimeOfImpact(const SweptOBB& a, const SweptOBB& b, float& toi) {
+	return ObbTimeOfImpact(a, MakeSweepBound(a), b, MakeSweepBound(b), toi);
+}
+
+size_t SweptObbSegmentTimeOfImpactBatch(std::span<const SweptOBB> obbs, const Segment& segment, uint8_t* hits, float* tois) {
+	MT2_PROFILE_SCOPE("SweptObbSegmentTimeOfImpactBatch");
+	const OBB segmentObb = MakeSegmentOBB(segment);
+	size_t hitCount = 0;
+	for (size_t i = 0; i < obbs.size(); ++i) {
+		float toi = 1.0f;
+		hits[i] = SegmentTimeOfImpact(obbs[i], MakeSweepBound(obbs[i]), segment, segmentObb, toi) ? 1 : 0;
+		tois[i] = hits[i] ? toi : 1.0f;
+		hitCount += hits[i];
+	}
+	return hitCount;
+}
+
+size_t SweptObbObbTimeOfImpactBatch(std::span<const SweptOBB> obbs, const ObbPair* pairs, size_t pairCount, uint8_t* hits, float* tois) {
+	MT2_PROFILE_SCOPE("SweptObbObbTimeOfImpactBatch");
+	//呼ぶたびに確保しないように使い回す
+	thread_local std::vector<SweepBound> bounds;
+	bounds.resize(obbs.size());
+	for (size_t i = 0; i < obbs.size(); ++i) {
+		bounds[i] = MakeSweepBound(obbs[i]);
+	}
+	size_t hitCount = 0;
+	for (size_t i = 0; i < pairCount; ++i) {
+		const ObbPair& pair = pairs[i];
+		float toi = 1.0f;
+		hits[i] = ObbTimeOfImpact(obbs[pair.a], bounds[pair.a], obbs[pair.b], bounds[pair.b], toi) ? 1 : 0;
+		tois[i] = hits[i] ? toi : 1.0f;
+		hitCount += hits[i];
+	}
+	return hitCount;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "Collision.h"
+#include "Quaternion.h"
+
+//OBBの位置と向き
+struct OBBPose {
+	Vector3 center;
+	Quaternion rotation;
+};
+
+//1ステップの間(時刻0から1)にstartからendへ動くOBB
+//中心は線形補間、向きはSlerpで補間する
+struct SweptOBB {
+	OBBPose start;
+	OBBPose end;
+	Vector3 size;
+};
+
+//これより近づいたら触れたとみなす距離
+const float kTimeOfImpactTolerance = 1.0e-3f;
+//保守的前進の最大の反復回数(使い切ったらその時刻で当たったとみなす)
+const uint32_t kTimeOfImpactMaxIterations = 128;
+
+//時刻tでのOBB
+OBB GetSweptOBBAt(const SweptOBB& obb, float t);
+//ステップ全体で通る範囲を囲むAABB
+AABB MakeSweptOBBAABB(const SweptOBB& obb);
+
+//止まっている線分に最初に触れる時刻(保守的前進。動く範囲のAABBで先に弾く)
+bool SweptObbSegmentTimeOfImpact(const SweptOBB& obb, const Segment& segment, float& toi);
+//動くOBB同士が最初に触れる時刻
+bool SweptObbObbTimeOfImpact(const SweptOBB& a, const SweptOBB& b, float& toi);
+
+//全てのOBBと1本の線分の判定(当たったものの数を返す。当たらなかったもののtoiは1)
+size_t SweptObbSegmentTimeOfImpactBatch(std::span<const SweptOBB> obbs, const Segment& segment, uint8_t* hits, float* tois);
+//OBBの組ごとの判定(AABBと動く速さの上限はOBBごとに1回だけ求める)
+size_t SweptObbObbTimeOfImpactBatch(std::span<const SweptOBB> obbs, const ObbPair* pairs, size_t pairCount, uint8_t* hits, float* tois);
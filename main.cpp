@@ -5,69 +5,31 @@
 #define _USE_MATH_DEFINES
 #include<math.h>
 #include <algorithm>
+#include <cstring>
+#include <vector>
+#include "MathFunction.h"
+#include "BVH.h"
+#include "Camera.h"
+#include "CollisionLoop.h"
+#include "Collision.h"
+#include "DebugLines.h"
+#include "FrameArena.h"
+#include "GridLineCache.h"
+#include "InverseBenchmark.h"
+#include "LineBatch.h"
+#include "Profiler.h"
+#include "ReplayLog.h"
+#include "SceneFile.h"
 
 const char kWindowTitle[] = "LD2B_08_ワタナベ_ナオ_タイトル";
 
-struct Vector3 {
-	float x;
-	float y;
-	float z;
+//LineBatchの線をNoviceで描く
+class NoviceLineSink : public ILineSink {
+public:
+	void Submit(std::span<const LineVertex> vertices, std::span<const uint32_t> colors) override;
 };
-struct Matrix4x4 {
-	float m[4][4];
-};
-
-struct AABB {
-	Vector3 min;
-	Vector3 max;
-};
-
-struct Segment {
-	Vector3 origin;//始点
-	Vector3 diff;//終点への差分ベクトル
-};
-
-struct OBB {
-	Vector3 center;
-	Vector3 orientations[3];
-	Vector3 size;
-};
-
-//X軸回転行列
-Matrix4x4 MakeRotateXMatrix(float radian);
-//Y軸回転行列
-Matrix4x4 MakeRotateYMatrix(float radian);
-//Z軸回転行列
-Matrix4x4 MakeRotateZMatrix(float radian);
-//3次元アフィン変換行列
-Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
-//逆行列
-Matrix4x4 Inverse(const Matrix4x4& m);
-//投資投影行列
-Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRadio, float nearClip, float farClip);
-//ビューポート行列
-Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth);
-//積
-Matrix4x4 MatrixMultiply(const Matrix4x4& m1, const Matrix4x4& m2);
-//スカラー倍
-Vector3 Multiply(float scalar, const Vector3 v);
-//座標変換
-Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix);
-//正規化
-Vector3 Normalize(Vector3 vector);
-//長さ
-float Length(const Vector3& v);
-//内積
-float Dot(const Vector3& v1, const Vector3& v2);
-//クロス積
-Vector3 Cross(const Vector3& v1, const Vector3& v2);
-Vector3 Add(const Vector3& v1, const Vector3& v2);
-Vector3 Subtract(const Vector3& v1, const Vector3& v2);
-
-void DrawGrit(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix);
-void DrawOBB(const OBB& obb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
-bool ObbSegmentIsCollision(const Segment& segment, const OBB& obb);
-bool AabbSegmentIsCollision(const AABB& aabb, const Segment& segment);
+//直前のフレームの区間をタイムラインで表示する
+void DrawProfilerWindow(const Profiler& profiler);
 
 
 // Windowsアプリでのエントリーポイント(main関数)
@@ -76,27 +38,47 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	// ライブラリの初期化
 	Novice::Initialize(kWindowTitle, 1280, 720);
 
-	Vector3 cameraTranslate{ 0.0f,1.9f,-6.49f };
-	Vector3 cameraRotate{ 0.26f,0.0f,0.0f };
 	Vector3 cameraPosition = { 0.0f,0.0f,-300.0f };
-	int kWindowWidth = 1280;
-	int kWindowHeight = 720;
 
 	int color = WHITE;
 
-	Vector3 rotate{ 0.0f,0.0f,0.0f };
-	OBB obb{
-		.center{-1.0f,0.0f,0.0f},
-		.orientations = {
-			{1.0f,0.0f,0.0f},
-			{0.0f,1.0f,0.0f},
-			{0.0f,0.0f,1.0f}},
-			.size{0.5f,0.5f,0.5f}
-	};
-	Segment segment{
-		{-0.8f,-0.3f,0.0f},
-		{0.5f,0.5f,0.5f}
-	};
+	//カメラ・OBB・線分と更新処理(ヘッドレスの再生と同じもの)
+	//カメラとビューポートの初期値は1280x720の画面に合わせてある
+	CollisionLoop loop;
+	Camera& camera = loop.camera;
+	OBB& obb = loop.obb;
+	Segment& segment = loop.segment;
+	//入力の記録(ImGuiで書き換えた値をフレームごとに残す)
+	ReplayRecorder replayRecorder;
+	ReplayResult replayResult = ReplayResult::kOk;
+	InverseBenchmarkResult inverseBenchmark{};
+	GridLineCache grid(2.0f, 10);
+	float gridHalfWidth = grid.GetHalfWidth();
+	int gridSubdivision = int(grid.GetSubdivision());
+	LineBatch lineBatch;
+	NoviceLineSink lineSink;
+	Profiler& profiler = Profiler::Get();
+	//フレーム内だけ使う一時バッファ(Novice::EndFrameの後で空にする)
+	FrameArena frameArena(64 * 1024);
+
+	//シーンファイルがあれば割り当てて、線分と当たるOBBを調べる(読み込み時にコピーはしない)
+	MappedSceneFile scene;
+	SceneFileResult sceneResult = scene.Open("scene.mt2scene");
+	//Openは中身を調べないので、BVHや逆行列に渡す前に全要素を検査する(壊れていれば使わない)
+	if (sceneResult == SceneFileResult::kOk) {
+		size_t sceneBadIndex = 0;
+		sceneResult = ValidateSceneFile(scene, sceneBadIndex);
+		if (sceneResult != SceneFileResult::kOk) {
+			scene.Close();
+		}
+	}
+	OBBBVH sceneBvh;
+	if (sceneResult == SceneFileResult::kOk) {
+		sceneBvh.Build(scene.GetOBBs());
+		loop.SetScene(&sceneBvh);
+	}
+	const size_t kMaxDrawSceneObbs = 64;
+
 	// キー入力結果を受け取る箱
 	char keys[256] = { 0 };
 	char preKeys[256] = { 0 };
@@ -105,6 +87,7 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	while (Novice::ProcessMessage() == 0) {
 		// フレームの開始
 		Novice::BeginFrame();
+		profiler.BeginFrame();
 
 		// キー入力を受け取る
 		memcpy(preKeys, keys, 256);
@@ -114,51 +97,79 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		/// ↓更新処理ここから
 		///
 
-		Matrix4x4 cameraMatrix = MakeAffineMatrix({ 1.0f,1.0f,1.0f }, cameraRotate, cameraTranslate);
-		Matrix4x4 viewMatrix = Inverse(cameraMatrix);
-		Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, float(kWindowWidth) / float(kWindowHeight), 0.1f, 100.0f);
-		Matrix4x4 worldViewProjectionMatrix = MatrixMultiply(viewMatrix, projectionMatrix);
-		Matrix4x4 viewportMatrix = MakeViewportMatrix(0, 0, float(kWindowWidth), float(kWindowHeight), 0.0f, 1.0f);
-
-		//回転行列を生成
-		Matrix4x4 rotateMatrix = MatrixMultiply(MakeRotateXMatrix(rotate.x), MatrixMultiply(MakeRotateYMatrix(rotate.y), MakeRotateZMatrix(rotate.z)));
-
-		//回転行列から軸を抽出
-		obb.orientations[0].x = rotateMatrix.m[0][0];
-		obb.orientations[0].y = rotateMatrix.m[0][1];
-		obb.orientations[0].z = rotateMatrix.m[0][2];
-
-		obb.orientations[1].x = rotateMatrix.m[1][0];
-		obb.orientations[1].y = rotateMatrix.m[1][1];
-		obb.orientations[1].z = rotateMatrix.m[1][2];
-
-		obb.orientations[2].x = rotateMatrix.m[2][0];
-		obb.orientations[2].y = rotateMatrix.m[2][1];
-		obb.orientations[2].z = rotateMatrix.m[2][2];
-
-		Vector3 start = Transform(Transform(segment.origin, worldViewProjectionMatrix), viewportMatrix);
-		Vector3 end = Transform(Transform(Add(segment.origin, segment.diff), worldViewProjectionMatrix), viewportMatrix);
-
-		
-		ImGui::Begin("Window");
-		ImGui::DragFloat3("CameraTranslate", &cameraTranslate.x, 0.01f);
-		ImGui::DragFloat3("CameraRotate", &cameraRotate.x, 0.01f);
-		ImGui::DragFloat3("obb.center", &obb.center.x, 0.01f);
-		ImGui::DragFloat("rotateX", &rotate.x, 0.01f);
-		ImGui::DragFloat("rotateY", &rotate.y, 0.01f);
-		ImGui::DragFloat("rotateZ", &rotate.z, 0.01f);
-		ImGui::DragFloat3("obb.orientations[0]", &obb.orientations[0].x, 0.01f);
-		ImGui::DragFloat3("obb.orientations[1]", &obb.orientations[1].x, 0.01f);
-		ImGui::DragFloat3("obb.orientations[2]", &obb.orientations[2].x, 0.01f);
-		ImGui::DragFloat3("obb.size", &obb.size.x, 0.01f);
-		ImGui::DragFloat3("segment.origin", &segment.origin.x, 0.01f);
-		ImGui::DragFloat3("segment.diff", &segment.diff.x, 0.01f);
-		ImGui::End();
-
+		//ImGuiで書き換える前の入力(記録するのは書き換えた差分だけ)
+		const FrameInput frameInputBefore = loop.GetInput();
+		{
+			MT2_PROFILE_SCOPE("ImGui");
+			ImGui::Begin("Window");
+			ImGui::DragFloat3("CameraTranslate", &camera.translate.x, 0.01f);
+			ImGui::DragFloat3("CameraRotate", &camera.rotate.x, 0.01f);
+			ImGui::Text("camera cache hit %llu miss %llu (total hit %llu miss %llu)",
+				(unsigned long long)camera.GetFrameStats().hits, (unsigned long long)camera.GetFrameStats().misses,
+				(unsigned long long)camera.GetTotalStats().hits, (unsigned long long)camera.GetTotalStats().misses);
+			ImGui::Text("obb visible %d", loop.IsObbVisible() ? 1 : 0);
+			ImGui::Text("swept hit %d toi %.3f", loop.IsSweptHit() ? 1 : 0, loop.GetSweptToi());
+			ImGui::Text("frame arena last %d high water %d capacity %d heap allocations %llu", int(frameArena.GetLastFrameUsed()),
+				int(frameArena.GetHighWater()), int(frameArena.GetCapacity()), (unsigned long long)frameArena.GetHeapAllocationCount());
+			ImGui::Text("scene.mt2scene %s obbs %llu segments %llu hits %d", GetSceneFileResultName(sceneResult),
+				(unsigned long long)scene.GetOBBs().count, (unsigned long long)scene.GetSegments().count, int(loop.GetSceneHitIndices().size()));
+			ImGui::DragFloat3("obb.center", &obb.center.x, 0.01f);
+			ImGui::DragFloat("rotateX", &loop.rotate.x, 0.01f);
+			ImGui::DragFloat("rotateY", &loop.rotate.y, 0.01f);
+			ImGui::DragFloat("rotateZ", &loop.rotate.z, 0.01f);
+			ImGui::DragFloat3("obb.spin", &loop.spin.x, 0.01f);
+			//軸は向きから作るので直接は編集しない(正規直交でなくなると判定が壊れる)
+			ImGui::Text("obb.orientations[0] %.3f %.3f %.3f", obb.orientations[0].x, obb.orientations[0].y, obb.orientations[0].z);
+			ImGui::Text("obb.orientations[1] %.3f %.3f %.3f", obb.orientations[1].x, obb.orientations[1].y, obb.orientations[1].z);
+			ImGui::Text("obb.orientations[2] %.3f %.3f %.3f", obb.orientations[2].x, obb.orientations[2].y, obb.orientations[2].z);
+			ImGui::DragFloat3("obb.size", &obb.size.x, 0.01f);
+			ImGui::DragFloat3("segment.origin", &segment.origin.x, 0.01f);
+			ImGui::DragFloat3("segment.diff", &segment.diff.x, 0.01f);
+			ImGui::DragFloat("grid.halfWidth", &gridHalfWidth, 0.01f);
+			ImGui::DragInt("grid.subdivision", &gridSubdivision, 1.0f, 1, 100);
+			//記録はMT2Replayで画面なしで再生できる
+			if (ImGui::Button(replayRecorder.IsRecording() ? "Stop recording" : "Record replay")) {
+				if (replayRecorder.IsRecording()) {
+					replayResult = replayRecorder.End("replay.mt2replay");
+				}
+				else {
+					replayRecorder.Begin(frameInputBefore, loop.GetObbRotation(), scene.IsOpen() ? scene.GetHeader().checksum : 0);
+				}
+			}
+			ImGui::Text("replay.mt2replay %s frames %u bytes %d", GetReplayResultName(replayResult), replayRecorder.GetFrameCount(),
+				int(replayRecorder.GetDataSize()));
+			if (ImGui::Button("Benchmark Inverse")) {
+				inverseBenchmark = BenchmarkInverse(100000);
+			}
+			ImGui::Text("Inverse        %.1f ns", inverseBenchmark.inverseNs);
+			ImGui::Text("InverseAffine  %.1f ns", inverseBenchmark.inverseAffineNs);
+			ImGui::Text("InverseRigid   %.1f ns", inverseBenchmark.inverseRigidNs);
+			ImGui::Text("OBB query (Inverse)      %.1f ns", inverseBenchmark.obbQueryInverseNs);
+			ImGui::Text("OBB query (InverseRigid) %.1f ns", inverseBenchmark.obbQueryRigidNs);
+			ImGui::End();
+			DrawProfilerWindow(profiler);
+		}
 
-		if (ObbSegmentIsCollision(segment, obb)) {
+		if (replayRecorder.IsRecording()) {
+			replayRecorder.Record(frameInputBefore, loop.GetInput());
+		}
+		//行列・向きの更新、視錐台カリング、衝突判定
+		loop.Update();
+		if (replayRecorder.IsRecording()) {
+			replayRecorder.RecordResult(loop);
+		}
+		const Matrix4x4& worldViewProjectionMatrix = camera.GetViewProjectionMatrix();
+		const Matrix4x4& viewportMatrix = camera.GetViewportMatrix();
+		const bool isHit = loop.IsHit();
+		const SegmentHit& segmentHit = loop.GetSegmentHit();
+		const std::vector<uint32_t>& sceneHitIndices = loop.GetSceneHitIndices();
+		if (isHit) {
 			color = RED;
 		}
+		else if (loop.IsSweptHit()) {
+			//今は離れているが、動きの途中で当たっていた
+			color = 0xFF8000FF;
+		}
 		else {
 			color = WHITE;
 		}
@@ -171,16 +182,42 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		/// ↓描画処理ここから6
 		///
 
-		DrawGrit(worldViewProjectionMatrix, viewportMatrix);
-		Novice::DrawLine(int(start.x), int(start.y), int(end.x), int(end.y), WHITE);
-		DrawOBB(obb, worldViewProjectionMatrix, viewportMatrix, color);
+		{
+			MT2_PROFILE_SCOPE("DrawGrid");
+			grid.SetParameters(gridHalfWidth, uint32_t(max(gridSubdivision, 1)));
+			grid.Update(worldViewProjectionMatrix, viewportMatrix);
+			//線は全て集めてからまとめて描く
+			AddGridLines(lineBatch, grid, 0xAAAAAAFF, BLACK);
+		}
+		AddLine3D(lineBatch, segment.origin, Add(segment.origin, segment.diff), worldViewProjectionMatrix, viewportMatrix, WHITE);
+		//画面外のOBBは頂点の変換もしない
+		if (loop.IsObbVisible()) {
+			MT2_PROFILE_SCOPE("DrawOBB");
+			AddOBBLines(lineBatch, obb, worldViewProjectionMatrix, viewportMatrix, color);
+		}
+		//シーンのOBBは線分と当たったものだけ描く
+		if (!sceneHitIndices.empty()) {
+			MT2_PROFILE_SCOPE("DrawSceneOBB");
+			std::span<const uint32_t> drawIndices(sceneHitIndices.data(), min(sceneHitIndices.size(), kMaxDrawSceneObbs));
+			AddOBBLines(lineBatch, scene.GetOBBs(), drawIndices, worldViewProjectionMatrix, viewportMatrix, GREEN, frameArena);
+		}
+		if (isHit) {
+			//当たった点から面の法線を短く描く
+			AddLine3D(lineBatch, segmentHit.point, Add(segmentHit.point, Multiply(0.3f, segmentHit.normal)), worldViewProjectionMatrix, viewportMatrix, BLUE);
+		}
+		lineBatch.Flush(lineSink);
 
 		///
 		/// ↑描画処理ここまで
 		///
 
 		// フレームの終了
-		Novice::EndFrame();
+		{
+			MT2_PROFILE_SCOPE("Novice::EndFrame");
+			Novice::EndFrame();
+		}
+		frameArena.EndFrame();
+		profiler.EndFrame();
 
 		// ESCキーが押されたらループを抜ける
 		if (preKeys[DIK_ESCAPE] == 0 && keys[DIK_ESCAPE] != 0) {
@@ -193,489 +230,69 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	return 0;
 }
 
-
-//積
-Matrix4x4 MatrixMultiply(const Matrix4x4& m1, const Matrix4x4& m2) {
-	Matrix4x4 result;
-
-	result.m[0][0] = m1.m[0][0] * m2.m[0][0] + m1.m[0][1] * m2.m[1][0] + m1.m[0][2] * m2.m[2][0] + m1.m[0][3] * m2.m[3][0];
-	result.m[0][1] = m1.m[0][0] * m2.m[0][1] + m1.m[0][1] * m2.m[1][1] + m1.m[0][2] * m2.m[2][1] + m1.m[0][3] * m2.m[3][1];
-	result.m[0][2] = m1.m[0][0] * m2.m[0][2] + m1.m[0][1] * m2.m[1][2] + m1.m[0][2] * m2.m[2][2] + m1.m[0][3] * m2.m[3][2];
-	result.m[0][3] = m1.m[0][0] * m2.m[0][3] + m1.m[0][1] * m2.m[1][3] + m1.m[0][2] * m2.m[2][3] + m1.m[0][3] * m2.m[3][3];
-	result.m[1][0] = m1.m[1][0] * m2.m[0][0] + m1.m[1][1] * m2.m[1][0] + m1.m[1][2] * m2.m[2][0] + m1.m[1][3] * m2.m[3][0];
-	result.m[1][1] = m1.m[1][0] * m2.m[0][1] + m1.m[1][1] * m2.m[1][1] + m1.m[1][2] * m2.m[2][1] + m1.m[1][3] * m2.m[3][1];
-	result.m[1][2] = m1.m[1][0] * m2.m[0][2] + m1.m[1][1] * m2.m[1][2] + m1.m[1][2] * m2.m[2][2] + m1.m[1][3] * m2.m[3][2];
-	result.m[1][3] = m1.m[1][0] * m2.m[0][3] + m1.m[1][1] * m2.m[1][3] + m1.m[1][2] * m2.m[2][3] + m1.m[1][3] * m2.m[3][3];
-	result.m[2][0] = m1.m[2][0] * m2.m[0][0] + m1.m[2][1] * m2.m[1][0] + m1.m[2][2] * m2.m[2][0] + m1.m[2][3] * m2.m[3][0];
-	result.m[2][1] = m1.m[2][0] * m2.m[0][1] + m1.m[2][1] * m2.m[1][1] + m1.m[2][2] * m2.m[2][1] + m1.m[2][3] * m2.m[3][1];
-	result.m[2][2] = m1.m[2][0] * m2.m[0][2] + m1.m[2][1] * m2.m[1][2] + m1.m[2][2] * m2.m[2][2] + m1.m[2][3] * m2.m[3][2];
-	result.m[2][3] = m1.m[2][0] * m2.m[0][3] + m1.m[2][1] * m2.m[1][3] + m1.m[2][2] * m2.m[2][3] + m1.m[2][3] * m2.m[3][3];
-	result.m[3][0] = m1.m[3][0] * m2.m[0][0] + m1.m[3][1] * m2.m[1][0] + m1.m[3][2] * m2.m[2][0] + m1.m[3][3] * m2.m[3][0];
-	result.m[3][1] = m1.m[3][0] * m2.m[0][1] + m1.m[3][1] * m2.m[1][1] + m1.m[3][2] * m2.m[2][1] + m1.m[3][3] * m2.m[3][1];
-	result.m[3][2] = m1.m[3][0] * m2.m[0][2] + m1.m[3][1] * m2.m[1][2] + m1.m[3][2] * m2.m[2][2] + m1.m[3][3] * m2.m[3][2];
-	result.m[3][3] = m1.m[3][0] * m2.m[0][3] + m1.m[3][1] * m2.m[1][3] + m1.m[3][2] * m2.m[2][3] + m1.m[3][3] * m2.m[3][3];
-
-	return result;
-}
-//スカラー倍
-Vector3 Multiply(float scalar, const Vector3 v) {
-	Vector3 result;
-
-	result.x = v.x * scalar;
-	result.y = v.y * scalar;
-	result.z = v.z * scalar;
-
-	return result;
-}
-//X軸回転行列
-Matrix4x4 MakeRotateXMatrix(float radian) {
-	Matrix4x4 result;
-
-	result.m[0][0] = 1;
-	result.m[0][1] = 0;
-	result.m[0][2] = 0;
-	result.m[0][3] = 0;
-	result.m[1][0] = 0;
-	result.m[1][1] = std::cos(radian);
-	result.m[1][2] = std::sin(radian);
-	result.m[1][3] = 0;
-	result.m[2][0] = 0;
-	result.m[2][1] = -std::sin(radian);
-	result.m[2][2] = std::cos(radian);
-	result.m[2][3] = 0;
-	result.m[3][0] = 0;
-	result.m[3][1] = 0;
-	result.m[3][2] = 0;
-	result.m[3][3] = 1;
-
-	return result;
-}
-
-//Y軸回転行列
-Matrix4x4 MakeRotateYMatrix(float radian) {
-	Matrix4x4 result;
-
-	result.m[0][0] = std::cos(radian);
-	result.m[0][1] = 0;
-	result.m[0][2] = -std::sin(radian);
-	result.m[0][3] = 0;
-	result.m[1][0] = 0;
-	result.m[1][1] = 1;
-	result.m[1][2] = 0;
-	result.m[1][3] = 0;
-	result.m[2][0] = std::sin(radian);
-	result.m[2][1] = 0;
-	result.m[2][2] = std::cos(radian);
-	result.m[2][3] = 0;
-	result.m[3][0] = 0;
-	result.m[3][1] = 0;
-	result.m[3][2] = 0;
-	result.m[3][3] = 1;
-
-	return result;
-}
-
-//Z軸回転行列
-Matrix4x4 MakeRotateZMatrix(float radian) {
-	Matrix4x4 result;
-
-	result.m[0][0] = std::cos(radian);
-	result.m[0][1] = std::sin(radian);
-	result.m[0][2] = 0;
-	result.m[0][3] = 0;
-	result.m[1][0] = -std::sin(radian);
-	result.m[1][1] = std::cos(radian);
-	result.m[1][2] = 0;
-	result.m[1][3] = 0;
-	result.m[2][0] = 0;
-	result.m[2][1] = 0;
-	result.m[2][2] = 1;
-	result.m[2][3] = 0;
-	result.m[3][0] = 0;
-	result.m[3][1] = 0;
-	result.m[3][2] = 0;
-	result.m[3][3] = 1;
-
-	return result;
-}
-
-//3次元アフィン変換行列
-Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
-	Matrix4x4 result;
-	Matrix4x4 rotateXMatrix = MakeRotateXMatrix(rotate.x);
-	Matrix4x4 rotateYMatrix = MakeRotateYMatrix(rotate.y);
-	Matrix4x4 rotateZMatrix = MakeRotateZMatrix(rotate.z);
-	Matrix4x4 rotateXYZMatrix = MatrixMultiply(rotateXMatrix, MatrixMultiply(rotateYMatrix, rotateZMatrix));
-
-	result.m[0][0] = scale.x * rotateXYZMatrix.m[0][0];
-	result.m[0][1] = scale.x * rotateXYZMatrix.m[0][1];
-	result.m[0][2] = scale.x * rotateXYZMatrix.m[0][2];
-	result.m[0][3] = 0;
-	result.m[1][0] = scale.y * rotateXYZMatrix.m[1][0];
-	result.m[1][1] = scale.y * rotateXYZMatrix.m[1][1];
-	result.m[1][2] = scale.y * rotateXYZMatrix.m[1][2];
-	result.m[1][3] = 0;
-	result.m[2][0] = scale.z * rotateXYZMatrix.m[2][0];
-	result.m[2][1] = scale.z * rotateXYZMatrix.m[2][1];
-	result.m[2][2] = scale.z * rotateXYZMatrix.m[2][2];
-	result.m[2][3] = 0;
-	result.m[3][0] = translate.x;
-	result.m[3][1] = translate.y;
-	result.m[3][2] = translate.z;
-	result.m[3][3] = 1;
-
-	return result;
-}
-
-//逆行列
-Matrix4x4 Inverse(const Matrix4x4& m) {
-	Matrix4x4 result;
-
-	float A = m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1] + m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2]
-		- m.m[0][0] * m.m[1][3] * m.m[2][2] * m.m[3][1] - m.m[0][0] * m.m[1][2] * m.m[2][1] * m.m[3][3] - m.m[0][0] * m.m[1][1] * m.m[2][3] * m.m[3][2]
-		- m.m[0][1] * m.m[1][0] * m.m[2][2] * m.m[3][3] - m.m[0][2] * m.m[1][0] * m.m[2][3] * m.m[3][1] - m.m[0][3] * m.m[1][0] * m.m[2][1] * m.m[3][2]
-		+ m.m[0][3] * m.m[1][0] * m.m[2][2] * m.m[3][1] + m.m[0][2] * m.m[1][0] * m.m[2][1] * m.m[3][3] + m.m[0][1] * m.m[1][0] * m.m[2][3] * m.m[3][2]
-		+ m.m[0][1] * m.m[1][2] * m.m[2][0] * m.m[3][3] + m.m[0][2] * m.m[1][3] * m.m[2][0] * m.m[3][1] + m.m[0][3] * m.m[1][1] * m.m[2][0] * m.m[3][2]
-		- m.m[0][3] * m.m[1][2] * m.m[2][0] * m.m[3][1] - m.m[0][2] * m.m[1][1] * m.m[2][0] * m.m[3][3] - m.m[0][1] * m.m[1][3] * m.m[2][0] * m.m[3][2]
-		- m.m[0][1] * m.m[1][2] * m.m[2][3] * m.m[3][0] - m.m[0][2] * m.m[1][3] * m.m[2][1] * m.m[3][0] - m.m[0][3] * m.m[1][1] * m.m[2][2] * m.m[3][0]
-		+ m.m[0][3] * m.m[1][2] * m.m[2][1] * m.m[3][0] + m.m[0][2] * m.m[1][1] * m.m[2][3] * m.m[3][0] + m.m[0][1] * m.m[1][3] * m.m[2][2] * m.m[3][0];
-
-	result.m[0][0] = (m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[1][2] * m.m[2][3] * m.m[3][1] + m.m[1][3] * m.m[2][1] * m.m[3][2] - (m.m[1][3] * m.m[2][2] * m.m[3][1]) - (m.m[1][2] * m.m[2][1] * m.m[3][3]) - (m.m[1][1] * m.m[2][3] * m.m[3][2])) / A;
-	result.m[0][1] = (-(m.m[0][1] * m.m[2][2] * m.m[3][3]) - (m.m[0][2] * m.m[2][3] * m.m[3][1]) - (m.m[0][3] * m.m[2][1] * m.m[3][2]) + m.m[0][3] * m.m[2][2] * m.m[3][1] + m.m[0][2] * m.m[2][1] * m.m[3][3] + m.m[0][1] * m.m[2][3] * m.m[3][2]) / A;
-	result.m[0][2] = (m.m[0][1] * m.m[1][2] * m.m[3][3] + m.m[0][2] * m.m[1][3] * m.m[3][1] + m.m[0][3] * m.m[1][1] * m.m[3][2] - (m.m[0][3] * m.m[1][2] * m.m[3][1]) - (m.m[0][2] * m.m[1][1] * m.m[3][3]) - (m.m[0][1] * m.m[1][3] * m.m[3][2])) / A;
-	result.m[0][3] = (-(m.m[0][1] * m.m[1][2] * m.m[2][3]) - (m.m[0][2] * m.m[1][3] * m.m[2][1]) - (m.m[0][3] * m.m[1][1] * m.m[2][2]) + m.m[0][3] * m.m[1][2] * m.m[2][1] + m.m[0][2] * m.m[1][1] * m.m[2][3] + m.m[0][1] * m.m[1][3] * m.m[2][2]) / A;
-	result.m[1][0] = (-(m.m[1][0] * m.m[2][2] * m.m[3][3]) - (m.m[1][2] * m.m[2][3] * m.m[3][0]) - (m.m[1][3] * m.m[2][0] * m.m[3][2]) + m.m[1][3] * m.m[2][2] * m.m[3][0] + m.m[1][2] * m.m[2][0] * m.m[3][3] + m.m[1][0] * m.m[2][3] * m.m[3][2]) / A;
-	result.m[1][1] = (m.m[0][0] * m.m[2][2] * m.m[3][3] + m.m[0][2] * m.m[2][3] * m.m[3][0] + m.m[0][3] * m.m[2][0] * m.m[3][2] - (m.m[0][3] * m.m[2][2] * m.m[3][0]) - (m.m[0][2] * m.m[2][0] * m.m[3][3]) - (m.m[0][0] * m.m[2][3] * m.m[3][2])) / A;
-	result.m[1][2] = (-(m.m[0][0] * m.m[1][2] * m.m[3][3]) - (m.m[0][2] * m.m[1][3] * m.m[3][0]) - (m.m[0][3] * m.m[1][0] * m.m[3][2]) + m.m[0][3] * m.m[1][2] * m.m[3][0] + m.m[0][2] * m.m[1][0] * m.m[3][3] + m.m[0][0] * m.m[1][3] * m.m[3][2]) / A;
-	result.m[1][3] = (m.m[0][0] * m.m[1][2] * m.m[2][3] + m.m[0][2] * m.m[1][3] * m.m[2][0] + m.m[0][3] * m.m[1][0] * m.m[2][2] - (m.m[0][3] * m.m[1][2] * m.m[2][0]) - (m.m[0][2] * m.m[1][0] * m.m[2][3]) - (m.m[0][0] * m.m[1][3] * m.m[2][2])) / A;
-	result.m[2][0] = (m.m[1][0] * m.m[2][1] * m.m[3][3] + m.m[1][1] * m.m[2][3] * m.m[3][0] + m.m[1][3] * m.m[2][0] * m.m[3][1] - (m.m[1][3] * m.m[2][1] * m.m[3][0]) - (m.m[1][1] * m.m[2][0] * m.m[3][3]) - (m.m[1][0] * m.m[2][3] * m.m[3][1])) / A;
-	result.m[2][1] = (-(m.m[0][0] * m.m[2][1] * m.m[3][3]) - (m.m[0][1] * m.m[2][3] * m.m[3][0]) - (m.m[0][3] * m.m[2][0] * m.m[3][1]) + m.m[0][3] * m.m[2][1] * m.m[3][0] + m.m[0][1] * m.m[2][0] * m.m[3][3] + m.m[0][0] * m.m[2][3] * m.m[3][1]) / A;
-	result.m[2][2] = (m.m[0][0] * m.m[1][1] * m.m[3][3] + m.m[0][1] * m.m[1][3] * m.m[3][0] + m.m[0][3] * m.m[1][0] * m.m[3][1] - (m.m[0][3] * m.m[1][1] * m.m[3][0]) - (m.m[0][1] * m.m[1][0] * m.m[3][3]) - (m.m[0][0] * m.m[1][3] * m.m[3][1])) / A;
-	result.m[2][3] = (-(m.m[0][0] * m.m[1][1] * m.m[2][3]) - (m.m[0][1] * m.m[1][3] * m.m[2][0]) - (m.m[0][3] * m.m[1][0] * m.m[2][1]) + m.m[0][3] * m.m[1][1] * m.m[2][0] + m.m[0][1] * m.m[1][0] * m.m[2][3] + m.m[0][0] * m.m[1][3] * m.m[2][1]) / A;
-	result.m[3][0] = (-(m.m[1][0] * m.m[2][1] * m.m[3][2]) - (m.m[1][1] * m.m[2][2] * m.m[3][0]) - (m.m[1][2] * m.m[2][0] * m.m[3][1]) + m.m[1][2] * m.m[2][1] * m.m[3][0] + m.m[1][1] * m.m[2][0] * m.m[3][2] + m.m[1][0] * m.m[2][2] * m.m[3][1]) / A;
-	result.m[3][1] = (m.m[0][0] * m.m[2][1] * m.m[3][2] + m.m[0][1] * m.m[2][2] * m.m[3][0] + m.m[0][2] * m.m[2][0] * m.m[3][1] - (m.m[0][2] * m.m[2][1] * m.m[3][0]) - (m.m[0][1] * m.m[2][0] * m.m[3][2]) - (m.m[0][0] * m.m[2][2] * m.m[3][1])) / A;
-	result.m[3][2] = (-(m.m[0][0] * m.m[1][1] * m.m[3][2]) - (m.m[0][1] * m.m[1][2] * m.m[3][0]) - (m.m[0][2] * m.m[1][0] * m.m[3][1]) + m.m[0][2] * m.m[1][1] * m.m[3][0] + m.m[0][1] * m.m[1][0] * m.m[3][2] + m.m[0][0] * m.m[1][2] * m.m[3][1]) / A;
-	result.m[3][3] = (m.m[0][0] * m.m[1][1] * m.m[2][2] + m.m[0][1] * m.m[1][2] * m.m[2][0] + m.m[0][2] * m.m[1][0] * m.m[2][1] - (m.m[0][2] * m.m[1][1] * m.m[2][0]) - (m.m[0][1] * m.m[1][0] * m.m[2][2]) - (m.m[0][0] * m.m[1][2] * m.m[2][1])) / A;
-
-	return result;
-}
-
-//投資投影行列
-Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRadio, float nearClip, float farClip) {
-	Matrix4x4 result;
-
-	result.m[0][0] = 1 / aspectRadio * (1 / std::tan(fovY / 2));
-	result.m[0][1] = 0;
-	result.m[0][2] = 0;
-	result.m[0][3] = 0;
-	result.m[1][0] = 0;
-	result.m[1][1] = 1 / std::tan(fovY / 2);
-	result.m[1][2] = 0;
-	result.m[1][3] = 0;
-	result.m[2][0] = 0;
-	result.m[2][1] = 0;
-	result.m[2][2] = farClip / (farClip - nearClip);
-	result.m[2][3] = 1;
-	result.m[3][0] = 0;
-	result.m[3][1] = 0;
-	result.m[3][2] = -(nearClip * farClip) / (farClip - nearClip);
-	result.m[3][3] = 0;
-
-	return result;
-}
-
-//ビューポート行列
-Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth) {
-	Matrix4x4 result;
-
-	result.m[0][0] = width / 2;
-	result.m[0][1] = 0;
-	result.m[0][2] = 0;
-	result.m[0][3] = 0;
-	result.m[1][0] = 0;
-	result.m[1][1] = -(height / 2);
-	result.m[1][2] = 0;
-	result.m[1][3] = 0;
-	result.m[2][0] = 0;
-	result.m[2][1] = 0;
-	result.m[2][2] = maxDepth - minDepth;
-	result.m[2][3] = 0;
-	result.m[3][0] = left + (width / 2);
-	result.m[3][1] = top + (height / 2);
-	result.m[3][2] = minDepth;
-	result.m[3][3] = 1;
-
-	return result;
+void NoviceLineSink::Submit(std::span<const LineVertex> vertices, std::span<const uint32_t> colors) {
+	for (size_t lineIndex = 0; lineIndex < colors.size(); ++lineIndex) {
+		const LineVertex& start = vertices[lineIndex * 2];
+		const LineVertex& end = vertices[lineIndex * 2 + 1];
+		Novice::DrawLine(start.x, start.y, end.x, end.y, colors[lineIndex]);
+	}
 }
 
-//座標変換
-Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix) {
-	Vector3 result;
-	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
-	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
-	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
-	float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
-	assert(w != 0.0f);
-	result.x /= w;
-	result.y /= w;
-	result.z /= w;
-	return result;
+//名前から区間の色を決める(同じ名前は毎フレーム同じ色になる)
+static ImU32 GetProfileColor(const char* name) {
+	uint32_t hash = 2166136261u;
+	for (const char* c = name; *c; ++c) {
+		hash = (hash ^ uint32_t(static_cast<unsigned char>(*c))) * 16777619u;
+	}
+	return IM_COL32(96 + (hash & 0x7F), 96 + ((hash >> 8) & 0x7F), 96 + ((hash >> 16) & 0x7F), 255);
 }
 
-//グリッド線の描画
-void DrawGrit(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix) {
-	const float kGridHalfWidth = 2.0f;//Gridの半分の幅
-	const uint32_t kSubdivision = 10;//分割数
-	const float kGridEvery = (kGridHalfWidth * 2.0f) / float(kSubdivision);//一つ分の長さ
-	Vector3 zLineStart;
-	Vector3 zLineEnd;
-	Vector3 xLineStart;
-	Vector3 xLineEnd;
-
-	//奥から手前への線を順々に引いていく
-	for (uint32_t xIndex = 0; xIndex <= kSubdivision; ++xIndex) {
-		//ワールド座標系上の始点と終点を求める
-		zLineStart = Vector3(xIndex * kGridEvery - kGridHalfWidth, 0, kGridHalfWidth);
-		zLineEnd = Vector3(xIndex * kGridEvery - kGridHalfWidth, 0, -kGridHalfWidth);
-		//スクリーン座標系まで変換をかける
-		Matrix4x4 zStartWorldMatrix = MakeAffineMatrix({ 1.0f,1.0f,1.0f }, Vector3{}, zLineStart);
-		Matrix4x4 zStartworldViewProjectionMatrix = MatrixMultiply(zStartWorldMatrix, viewProjectionMatrix);
-		Vector3 zStartNdcVertex = Transform(Vector3{}, zStartworldViewProjectionMatrix);
-		Vector3 zStartScreenVertice = Transform(zStartNdcVertex, viewportMatrix);
-
-		Matrix4x4 zEndWorldMatrix = MakeAffineMatrix({ 1.0f,1.0f,1.0f }, Vector3{}, zLineEnd);
-		Matrix4x4 zEndworldViewProjectionMatrix = MatrixMultiply(zEndWorldMatrix, viewProjectionMatrix);
-		Vector3 zEndNdcVertex = Transform(Vector3{}, zEndworldViewProjectionMatrix);
-		Vector3 zEndScreenVertice = Transform(zEndNdcVertex, viewportMatrix);
-
-		if (xIndex == 5) {
-			Novice::DrawLine((int)zStartScreenVertice.x, (int)zStartScreenVertice.y, (int)zEndScreenVertice.x, (int)zEndScreenVertice.y, BLACK);
-		}
-		else {
-			Novice::DrawLine((int)zStartScreenVertice.x, (int)zStartScreenVertice.y, (int)zEndScreenVertice.x, (int)zEndScreenVertice.y, 0xAAAAAAFF);
-		}
+void DrawProfilerWindow(const Profiler& profiler) {
+	ImGui::Begin("Profiler");
+	if (profiler.GetFrameCount() == 0) {
+		ImGui::End();
+		return;
 	}
 
-	//左から右も同じように順々に引いていく
-	for (uint32_t zIndex = 0; zIndex <= kSubdivision; ++zIndex) {
-		//ワールド座標系上の始点と終点を求める
-		xLineStart = Vector3(kGridHalfWidth, 0, zIndex * kGridEvery - kGridHalfWidth);
-		xLineEnd = Vector3(-kGridHalfWidth, 0, zIndex * kGridEvery - kGridHalfWidth);
-		//スクリーン座標系まで変換をかける
-		Matrix4x4 xStartWorldMatrix = MakeAffineMatrix({ 1.0f,1.0f,1.0f }, Vector3{}, xLineStart);
-		Matrix4x4 xStartworldViewProjectionMatrix = MatrixMultiply(xStartWorldMatrix, viewProjectionMatrix);
-		Vector3 xStartNdcVertex = Transform(Vector3{}, xStartworldViewProjectionMatrix);
-		Vector3 xStartScreenVertice = Transform(xStartNdcVertex, viewportMatrix);
-
-		Matrix4x4 xEndWorldMatrix = MakeAffineMatrix({ 1.0f,1.0f,1.0f }, Vector3{}, xLineEnd);
-		Matrix4x4 xEndworldViewProjectionMatrix = MatrixMultiply(xEndWorldMatrix, viewProjectionMatrix);
-		Vector3 xEndNdcVertex = Transform(Vector3{}, xEndworldViewProjectionMatrix);
-		Vector3 xEndScreenVertice = Transform(xEndNdcVertex, viewportMatrix);
-
-		if (zIndex == 5) {
-			Novice::DrawLine((int)xStartScreenVertice.x, (int)xStartScreenVertice.y, (int)xEndScreenVertice.x, (int)xEndScreenVertice.y, BLACK);
+	//フレーム時間の推移(古い順)
+	const int kHistoryCount = 120;
+	float frameMs[kHistoryCount] = {};
+	int historyCount = int(min(profiler.GetFrameCount(), size_t(kHistoryCount)));
+	for (int i = 0; i < historyCount; ++i) {
+		frameMs[i] = float(double(profiler.GetFrame(size_t(historyCount - 1 - i)).durationNs) * 1.0e-6);
+	}
+	ImGui::PlotLines("frame ms", frameMs, historyCount, 0, nullptr, 0.0f, 33.3f, ImVec2(0.0f, 40.0f));
+
+	const ProfileFrame& frame = profiler.GetFrame(0);
+	ImGui::Text("frame %llu  %.3f ms  scopes %d  dropped %u", (unsigned long long)frame.index,
+		double(frame.durationNs) * 1.0e-6, int(frame.events.size()), frame.droppedCount);
+
+	//横軸がフレーム内の時刻、縦が入れ子の深さのタイムライン
+	const float kRowHeight = 18.0f;
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	ImVec2 origin = ImGui::GetCursorScreenPos();
+	float width = max(ImGui::GetContentRegionAvail().x, 1.0f);
+	float nsToPixel = frame.durationNs > 0 ? width / float(frame.durationNs) : 0.0f;
+	uint32_t maxDepth = 0;
+	for (const ProfileEvent& event : frame.events) {
+		float x0 = origin.x + float(event.startNs - frame.startNs) * nsToPixel;
+		float x1 = max(x0 + float(event.durationNs) * nsToPixel, x0 + 1.0f);
+		float y0 = origin.y + float(event.depth) * kRowHeight;
+		float y1 = y0 + kRowHeight - 1.0f;
+		drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), GetProfileColor(event.name));
+		//名前が収まる幅のときだけ書く
+		if (x1 - x0 > 48.0f) {
+			drawList->AddText(ImVec2(x0 + 2.0f, y0 + 2.0f), IM_COL32(0, 0, 0, 255), event.name);
 		}
-		else {
-			Novice::DrawLine((int)xStartScreenVertice.x, (int)xStartScreenVertice.y, (int)xEndScreenVertice.x, (int)xEndScreenVertice.y, 0xAAAAAAFF);
+		if (ImGui::IsMouseHoveringRect(ImVec2(x0, y0), ImVec2(x1, y1))) {
+			ImGui::SetTooltip("%s  %.3f ms", event.name, double(event.durationNs) * 1.0e-6);
 		}
+		maxDepth = max(maxDepth, event.depth);
 	}
-}
-
-//正規化
-Vector3 Normalize(Vector3 vector) {
-	float lenght;
-	Vector3 result{};
+	ImGui::Dummy(ImVec2(width, float(maxDepth + 1) * kRowHeight));
 
-	lenght = sqrtf((vector.x * vector.x) + (vector.y * vector.y) + (vector.z * vector.z));
-	if (lenght != 0) {
-		result.x = vector.x / lenght;
-		result.y = vector.y / lenght;
-		result.z = vector.z / lenght;
+	if (ImGui::Button("Export trace")) {
+		profiler.WriteChromeTrace("profile_trace.json");
 	}
-	return result;
-}
-//長さ（ノルム）
-float Length(const Vector3& v) {
-	float result;
-
-	result = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
-
-	return result;
-}
-//内積
-float Dot(const Vector3& v1, const Vector3& v2) {
-	Vector3 v3;
-	float result;
-
-	v3.x = v1.x * v2.x;
-	v3.y = v1.y * v2.y;
-	v3.z = v1.z * v2.z;
-
-	result = v3.x + v3.y + v3.z;
-
-	return result;
-}
-//クロス積
-Vector3 Cross(const Vector3& v1, const Vector3& v2) {
-	Vector3 result;
-
-	result = { v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x };
-
-	return result;
-}
-//加算
-Vector3 Add(const Vector3& v1, const Vector3& v2) {
-	Vector3 result;
-
-	result.x = v1.x + v2.x;
-	result.y = v1.y + v2.y;
-	result.z = v1.z + v2.z;
-
-	return result;
+	ImGui::End();
 }
-//減算
-Vector3 Subtract(const Vector3& v1, const Vector3& v2) {
-	Vector3 result;
-
-	result.x = v1.x - v2.x;
-	result.y = v1.y - v2.y;
-	result.z = v1.z - v2.z;
-
-	return result;
-}
-
-
-void DrawOBB(const OBB& obb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color) {
-
-	Vector3 rightTopFront = { -obb.size.x, obb.size.y, -obb.size.z };
-	Vector3 leftTopFront = { obb.size.x, obb.size.y, -obb.size.z };
-	Vector3 rightDownFront = { -obb.size.x, -obb.size.y, -obb.size.z };
-	Vector3 leftDownFront = { obb.size.x, -obb.size.y, -obb.size.z };
-	Vector3 rightTopBehind = { -obb.size.x, obb.size.y, obb.size.z };
-	Vector3 leftTopBehind = { obb.size.x, obb.size.y, obb.size.z };
-	Vector3 rightDownBehind = { -obb.size.x, -obb.size.y, obb.size.z };
-	Vector3 leftDownBehind = { obb.size.x, -obb.size.y, obb.size.z };
-
-	Matrix4x4 obbworldMatrix = {
-	obb.orientations[0].x,obb.orientations[0].y,obb.orientations[0].z,0,
-	obb.orientations[1].x,obb.orientations[1].y,obb.orientations[1].z,0,
-	obb.orientations[2].x,obb.orientations[2].y,obb.orientations[2].z,0,
-	obb.center.x,obb.center.y,obb.center.z,1
-	};
-
-	Matrix4x4 worldViewProjectionMatrix = MatrixMultiply(obbworldMatrix, viewProjectionMatrix);
-
-	Vector3 rtfVertex = Transform(rightTopFront, worldViewProjectionMatrix);
-	Vector3 ltfVertex = Transform(leftTopFront, worldViewProjectionMatrix);
-	Vector3 rdfVertex = Transform(rightDownFront, worldViewProjectionMatrix);
-	Vector3 ldfVertex = Transform(leftDownFront, worldViewProjectionMatrix);
-	Vector3 rtbVertex = Transform(rightTopBehind, worldViewProjectionMatrix);
-	Vector3 ltbVertex = Transform(leftTopBehind, worldViewProjectionMatrix);
-	Vector3 rdbVertex = Transform(rightDownBehind, worldViewProjectionMatrix);
-	Vector3 ldbVertex = Transform(leftDownBehind, worldViewProjectionMatrix);
-
-	Vector3 screenrtfVertex = Transform(rtfVertex, viewportMatrix);//右上前
-	Vector3 screenltfVertex = Transform(ltfVertex, viewportMatrix);//左上前
-	Vector3 screenrdfVertex = Transform(rdfVertex, viewportMatrix);//右下前
-	Vector3 screenldfVertex = Transform(ldfVertex, viewportMatrix);//左下前
-	Vector3 screenrtbVertex = Transform(rtbVertex, viewportMatrix);//右上後ろ
-	Vector3 screenltbVertex = Transform(ltbVertex, viewportMatrix);//左上後ろ
-	Vector3 screenrdbVertex = Transform(rdbVertex, viewportMatrix);//右下後ろ
-	Vector3 screenldbVertex = Transform(ldbVertex, viewportMatrix);//左下後ろ
-
-	Novice::DrawLine((int)screenrtfVertex.x, (int)screenrtfVertex.y, (int)screenltfVertex.x, (int)screenltfVertex.y, color);
-	Novice::DrawLine((int)screenrdfVertex.x, (int)screenrdfVertex.y, (int)screenldfVertex.x, (int)screenldfVertex.y, color);
-	Novice::DrawLine((int)screenrtbVertex.x, (int)screenrtbVertex.y, (int)screenltbVertex.x, (int)screenltbVertex.y, color);
-	Novice::DrawLine((int)screenrdbVertex.x, (int)screenrdbVertex.y, (int)screenldbVertex.x, (int)screenldbVertex.y, color);
-	Novice::DrawLine((int)screenrtfVertex.x, (int)screenrtfVertex.y, (int)screenrtbVertex.x, (int)screenrtbVertex.y, color);
-	Novice::DrawLine((int)screenltfVertex.x, (int)screenltfVertex.y, (int)screenltbVertex.x, (int)screenltbVertex.y, color);
-	Novice::DrawLine((int)screenrdfVertex.x, (int)screenrdfVertex.y, (int)screenrdbVertex.x, (int)screenrdbVertex.y, color);
-	Novice::DrawLine((int)screenldfVertex.x, (int)screenldfVertex.y, (int)screenldbVertex.x, (int)screenldbVertex.y, color);
-	Novice::DrawLine((int)screenrtfVertex.x, (int)screenrtfVertex.y, (int)screenrdfVertex.x, (int)screenrdfVertex.y, color);
-	Novice::DrawLine((int)screenltfVertex.x, (int)screenltfVertex.y, (int)screenldfVertex.x, (int)screenldfVertex.y, color);
-	Novice::DrawLine((int)screenrtbVertex.x, (int)screenrtbVertex.y, (int)screenrdbVertex.x, (int)screenrdbVertex.y, color);
-	Novice::DrawLine((int)screenltbVertex.x, (int)screenltbVertex.y, (int)screenldbVertex.x, (int)screenldbVertex.y, color);
-
-}
-
-bool AabbSegmentIsCollision(const AABB& aabb, const Segment& segment) {
-	float tXmin = (aabb.min.x - segment.origin.x) / segment.diff.x;
-	float tXmax = (aabb.max.x - segment.origin.x) / segment.diff.x;
-	float tYmin = (aabb.min.y - segment.origin.y) / segment.diff.y;
-	float tYmax = (aabb.max.y - segment.origin.y) / segment.diff.y;
-	float tZmin = (aabb.min.z - segment.origin.z) / segment.diff.z;
-	float tZmax = (aabb.max.z - segment.origin.z) / segment.diff.z;
-
-	float tNearX = min(tXmin, tXmax);
-	float tNearY = min(tYmin, tYmax);
-	float tNearZ = min(tZmin, tZmax);
-	float tFarX = max(tXmin, tXmax);
-	float tFarY = max(tYmin, tYmax);
-	float tFarZ = max(tZmin, tZmax);
-
-	//AABBとの衝突点（貫通点）のtが小さい方
-	float tmin = max(max(tNearX, tNearY), tNearZ);
-	//AABBとの衝突点（貫通点）のtが大きい方
-	float tmax = min(min(tFarX, tFarY), tFarZ);
-	if (tmin <= tmax) {
-		return true;
-	}
-	else {
-		return false;
-	}
-
-}
-
-bool ObbSegmentIsCollision(const Segment& segment, const OBB& obb) {
-	//float tXmin = (-obb.size.x - segment.origin.x) / segment.diff.x;
-	//float tXmax = (obb.size.x - segment.origin.x) / segment.diff.x;
-	//float tYmin = (-obb.size.y - segment.origin.y) / segment.diff.y;
-	//float tYmax = (obb.size.y - segment.origin.y) / segment.diff.y;
-	//float tZmin = (-obb.size.z - segment.origin.z) / segment.diff.z;
-	//float tZmax = (obb.size.z - segment.origin.z) / segment.diff.z;
-
-	//float tNearX = min(tXmin, tXmax);
-	//float tNearY = min(tYmin, tYmax);
-	//float tNearZ = min(tZmin, tZmax);
-	//float tFarX = max(tXmin, tXmax);
-	//float tFarY = max(tYmin, tYmax);
-	//float tFarZ = max(tZmin, tZmax);
-
-	////AABBとの衝突点（貫通点）のtが小さい方
-	//float tmin = max(max(tNearX, tNearY), tNearZ);
-	////AABBとの衝突点（貫通点）のtが大きい方
-	//float tmax = min(min(tFarX, tFarY), tFarZ);
-	//if (tmin <= tmax) {
-	//	return true;
-	//}
-	//else {
-	//	return false;
-	//}
-
-	Matrix4x4 worldMatrix = {
-	obb.orientations[0].x,obb.orientations[0].y,obb.orientations[0].z,0,
-	obb.orientations[1].x,obb.orientations[1].y,obb.orientations[1].z,0,
-	obb.orientations[2].x,obb.orientations[2].y,obb.orientations[2].z,0,
-	obb.center.x,obb.center.y,obb.center.z,1
-	};
-	Matrix4x4 obbWorldMatrixInverce = Inverse(worldMatrix);
-
-	Vector3 localOrigin = Transform(segment.origin, obbWorldMatrixInverce);
-	Vector3 localEnd = Transform(Add(segment.origin, segment.diff), obbWorldMatrixInverce);
-
-	AABB localAABB{
-		{-obb.size.x,-obb.size.y,-obb.size.z},
-		{obb.size.x,obb.size.y,obb.size.z},
-	};
-
-	Segment localSegment;
-	localSegment.origin = localOrigin;
-	localSegment.diff = Subtract(localEnd, localOrigin);
-
-	if (AabbSegmentIsCollision(localAABB,localSegment)) {
-		return true;
-	}
-	else {
-		return false;
-	}
-}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "Camera.h"
+#include <cstring>
+#include "StructuredMatrix.h"
+
+void Camera::Count(bool hit) {
+	if (hit) {
+		frameStats_.hits++;
+		totalStats_.hits++;
+	}
+	else {
+		frameStats_.misses++;
+		totalStats_.misses++;
+	}
+}
+
+void Camera::Update() {
+	frameStats_ = {};
+
+	//ビュー行列
+	bool viewChanged = !initialized_ ||
+		std::memcmp(&translate, &cachedTranslate_, sizeof(Vector3)) != 0 ||
+		std::memcmp(&rotate, &cachedRotate_, sizeof(Vector3)) != 0;
+	if (viewChanged) {
+		cachedTranslate_ = translate;
+		cachedRotate_ = rotate;
+		cameraMatrix_ = MakeAffineMatrix({ 1.0f,1.0f,1.0f }, rotate, translate);
+		viewMatrix_ = InverseRigid(cameraMatrix_);
+	}
+	Count(!viewChanged);
+
+	//射影行列
+	const float projection[4] = { fovY,aspectRatio,nearClip,farClip };
+	bool projectionChanged = !initialized_ || std::memcmp(projection, cachedProjection_, sizeof(projection)) != 0;
+	if (projectionChanged) {
+		std::memcpy(cachedProjection_, projection, sizeof(projection));
+		projectionMatrix_ = MakePerspectiveFovMatrix(fovY, aspectRatio, nearClip, farClip);
+	}
+	Count(!projectionChanged);
+
+	//ビュー射影行列はどちらかが変わったときだけ
+	bool viewProjectionChanged = viewChanged || projectionChanged;
+	if (viewProjectionChanged) {
+		//ビュー行列はアフィン変換なので4列目の掛け算を省く
+		viewProjectionMatrix_ = MatrixMultiply(ToAffineMatrix3x4(viewMatrix_), projectionMatrix_);
+	}
+	Count(!viewProjectionChanged);
+
+	//ビューポート行列
+	const float viewport[6] = { viewportLeft,viewportTop,viewportWidth,viewportHeight,minDepth,maxDepth };
+	bool viewportChanged = !initialized_ || std::memcmp(viewport, cachedViewport_, sizeof(viewport)) != 0;
+	if (viewportChanged) {
+		std::memcpy(cachedViewport_, viewport, sizeof(viewport));
+		viewportMatrix_ = MakeViewportMatrix(viewportLeft, viewportTop, viewportWidth, viewportHeight, minDepth, maxDepth);
+	}
+	Count(!viewportChanged);
+
+	initialized_ = true;
+}
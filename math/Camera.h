@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include "MathFunction.h"
+
+//カメラ
+//入力が変わった段階の行列だけ計算し直す(ImGuiから直接書き換えられるように入力は公開している)
+class Camera {
+public:
+	//キャッシュの当たり/外れの回数(段階ごとに数える)
+	struct CacheStats {
+		uint64_t hits;
+		uint64_t misses;
+	};
+
+	//ビュー
+	Vector3 translate{};
+	Vector3 rotate{};
+	//射影
+	float fovY = 0.45f;
+	float aspectRatio = 16.0f / 9.0f;
+	float nearClip = 0.1f;
+	float farClip = 100.0f;
+	//ビューポート
+	float viewportLeft = 0.0f;
+	float viewportTop = 0.0f;
+	float viewportWidth = 1280.0f;
+	float viewportHeight = 720.0f;
+	float minDepth = 0.0f;
+	float maxDepth = 1.0f;
+
+	void Update();
+
+	const Matrix4x4& GetCameraMatrix() const { return cameraMatrix_; }
+	const Matrix4x4& GetViewMatrix() const { return viewMatrix_; }
+	const Matrix4x4& GetProjectionMatrix() const { return projectionMatrix_; }
+	const Matrix4x4& GetViewProjectionMatrix() const { return viewProjectionMatrix_; }
+	const Matrix4x4& GetViewportMatrix() const { return viewportMatrix_; }
+	//直前のUpdateでの回数
+	const CacheStats& GetFrameStats() const { return frameStats_; }
+	//累計
+	const CacheStats& GetTotalStats() const { return totalStats_; }
+
+private:
+	void Count(bool hit);
+
+	bool initialized_ = false;
+	Vector3 cachedTranslate_{};
+	Vector3 cachedRotate_{};
+	float cachedProjection_[4] = {};
+	float cachedViewport_[6] = {};
+
+	Matrix4x4 cameraMatrix_{};
+	Matrix4x4 viewMatrix_{};
+	Matrix4x4 projectionMatrix_{};
+	Matrix4x4 viewProjectionMatrix_{};
+	Matrix4x4 viewportMatrix_{};
+	CacheStats frameStats_{};
+	CacheStats totalStats_{};
+};
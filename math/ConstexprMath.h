@@ -0,0 +1,56 @@
+#pragma once
+#include <cmath>
+#include <type_traits>
+
+//コンパイル時にも使える三角関数
+//実行時は標準ライブラリを呼ぶので結果は今まで通りで、コンパイル時だけdoubleの多項式で求める
+//(コンパイル時の値は実行時の値と最下位ビットが違うことがある)
+
+constexpr double kConstexprPi = 3.14159265358979323846;
+
+//[-π/2, π/2]のsin(x^17までのテイラー展開。端でも誤差は1e-13程度)
+constexpr double ConstexprSinPolynomial(double x) {
+	double x2 = x * x;
+	double term = x;
+	double sum = x;
+	for (int n = 1; n <= 8; ++n) {
+		term *= -x2 / double((2 * n) * (2 * n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+//角度を[-π/2, π/2]に移してからsinを求める
+constexpr double ConstexprSinReduced(double x) {
+	double turns = x / (2.0 * kConstexprPi);
+	long long nearest = static_cast<long long>(turns >= 0.0 ? turns + 0.5 : turns - 0.5);
+	x -= double(nearest) * 2.0 * kConstexprPi;
+	if (x > kConstexprPi / 2.0) {
+		x = kConstexprPi - x;
+	}
+	else if (x < -kConstexprPi / 2.0) {
+		x = -kConstexprPi - x;
+	}
+	return ConstexprSinPolynomial(x);
+}
+
+constexpr float ConstexprSin(float radian) {
+	if (std::is_constant_evaluated()) {
+		return float(ConstexprSinReduced(radian));
+	}
+	return std::sin(radian);
+}
+
+constexpr float ConstexprCos(float radian) {
+	if (std::is_constant_evaluated()) {
+		return float(ConstexprSinReduced(double(radian) + kConstexprPi / 2.0));
+	}
+	return std::cos(radian);
+}
+
+constexpr float ConstexprTan(float radian) {
+	if (std::is_constant_evaluated()) {
+		return float(ConstexprSinReduced(radian) / ConstexprSinReduced(double(radian) + kConstexprPi / 2.0));
+	}
+	return std::tan(radian);
+}
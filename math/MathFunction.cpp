@@ -0,0 +1,398 @@
+#include "MathFunction.h"
+#include <cassert>
+#include <cmath>
+#include "Simd.h"
+#include "StructuredMatrix.h"
+
+//3次元アフィン変換行列をまとめて作る
+void MakeAffineMatrices(std::span<const Vector3> scales, std::span<const Vector3> rotates, std::span<const Vector3> translates, std::span<AffineMatrix3x4> out) {
+	assert(scales.size() == out.size() && rotates.size() == out.size() && translates.size() == out.size());
+	for (size_t i = 0; i < out.size(); ++i) {
+		const Vector3& scale = scales[i];
+		const Vector3& rotate = rotates[i];
+		float sx = std::sin(rotate.x);
+		float cx = std::cos(rotate.x);
+		float sy = std::sin(rotate.y);
+		float cy = std::cos(rotate.y);
+		float sz = std::sin(rotate.z);
+		float cz = std::cos(rotate.z);
+
+		//MakeRotateXYZMatrixの各行に倍率を掛ける(計算の順番も同じにしてある)
+		AffineMatrix3x4& result = out[i];
+		result.m[0][0] = cy * cz * scale.x;
+		result.m[0][1] = cy * sz * scale.x;
+		result.m[0][2] = -sy * scale.x;
+		result.m[1][0] = (sx * sy * cz - cx * sz) * scale.y;
+		result.m[1][1] = (sx * sy * sz + cx * cz) * scale.y;
+		result.m[1][2] = sx * cy * scale.y;
+		result.m[2][0] = (cx * sy * cz + sx * sz) * scale.z;
+		result.m[2][1] = (cx * sy * sz - sx * cz) * scale.z;
+		result.m[2][2] = cx * cy * scale.z;
+		result.m[3][0] = translates[i].x;
+		result.m[3][1] = translates[i].y;
+		result.m[3][2] = translates[i].z;
+	}
+}
+
+//逆行列
+Matrix4x4 Inverse(const Matrix4x4& m) {
+	Matrix4x4 result;
+
+	float A = m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1] + m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2]
+		- m.m[0][0] * m.m[1][3] * m.m[2][2] * m.m[3][1] - m.m[0][0] * m.m[1][2] * m.m[2][1] * m.m[3][3] - m.m[0][0] * m.m[1][1] * m.m[2][3] * m.m[3][2]
+		- m.m[0][1] * m.m[1][0] * m.m[2][2] * m.m[3][3] - m.m[0][2] * m.m[1][0] * m.m[2][3] * m.m[3][1] - m.m[0][3] * m.m[1][0] * m.m[2][1] * m.m[3][2]
+		+ m.m[0][3] * m.m[1][0] * m.m[2][2] * m.m[3][1] + m.m[0][2] * m.m[1][0] * m.m[2][1] * m.m[3][3] + m.m[0][1] * m.m[1][0] * m.m[2][3] * m.m[3][2]
+		+ m.m[0][1] * m.m[1][2] * m.m[2][0] * m.m[3][3] + m.m[0][2] * m.m[1][3] * m.m[2][0] * m.m[3][1] + m.m[0][3] * m.m[1][1] * m.m[2][0] * m.m[3][2]
+		- m.m[0][3] * m.m[1][2] * m.m[2][0] * m.m[3][1] - m.m[0][2] * m.m[1][1] * m.m[2][0] * m.m[3][3] - m.m[0][1] * m.m[1][3] * m.m[2][0] * m.m[3][2]
+		- m.m[0][1] * m.m[1][2] * m.m[2][3] * m.m[3][0] - m.m[0][2] * m.m[1][3] * m.m[2][1] * m.m[3][0] - m.m[0][3] * m.m[1][1] * m.m[2][2] * m.m[3][0]
+		+ m.m[0][3] * m.m[1][2] * m.m[2][1] * m.m[3][0] + m.m[0][2] * m.m[1][1] * m.m[2][3] * m.m[3][0] + m.m[0][1] * m.m[1][3] * m.m[2][2] * m.m[3][0];
+
+	result.m[0][0] = (m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[1][2] * m.m[2][3] * m.m[3][1] + m.m[1][3] * m.m[2][1] * m.m[3][2] - (m.m[1][3] * m.m[2][2] * m.m[3][1]) - (m.m[1][2] * m.m[2][1] * m.m[3][3]) - (m.m[1][1] * m.m[2][3] * m.m[3][2])) / A;
+	result.m[0][1] = (-(m.m[0][1] * m.m[2][2] * m.m[3][3]) - (m.m[0][2] * m.m[2][3] * m.m[3][1]) - (m.m[0][3] * m.m[2][1] * m.m[3][2]) + m.m[0][3] * m.m[2][2] * m.m[3][1] + m.m[0][2] * m.m[2][1] * m.m[3][3] + m.m[0][1] * m.m[2][3] * m.m[3][2]) / A;
+	result.m[0][2] = (m.m[0][1] * m.m[1][2] * m.m[3][3] + m.m[0][2] * m.m[1][3] * m.m[3][1] + m.m[0][3] * m.m[1][1] * m.m[3][2] - (m.m[0][3] * m.m[1][2] * m.m[3][1]) - (m.m[0][2] * m.m[1][1] * m.m[3][3]) - (m.m[0][1] * m.m[1][3] * m.m[3][2])) / A;
+	result.m[0][3] = (-(m.m[0][1] * m.m[1][2] * m.m[2][3]) - (m.m[0][2] * m.m[1][3] * m.m[2][1]) - (m.m[0][3] * m.m[1][1] * m.m[2][2]) + m.m[0][3] * m.m[1][2] * m.m[2][1] + m.m[0][2] * m.m[1][1] * m.m[2][3] + m.m[0][1] * m.m[1][3] * m.m[2][2]) / A;
+	result.m[1][0] = (-(m.m[1][0] * m.m[2][2] * m.m[3][3]) - (m.m[1][2] * m.m[2][3] * m.m[3][0]) - (m.m[1][3] * m.m[2][0] * m.m[3][2]) + m.m[1][3] * m.m[2][2] * m.m[3][0] + m.m[1][2] * m.m[2][0] * m.m[3][3] + m.m[1][0] * m.m[2][3] * m.m[3][2]) / A;
+	result.m[1][1] = (m.m[0][0] * m.m[2][2] * m.m[3][3] + m.m[0][2] * m.m[2][3] * m.m[3][0] + m.m[0][3] * m.m[2][0] * m.m[3][2] - (m.m[0][3] * m.m[2][2] * m.m[3][0]) - (m.m[0][2] * m.m[2][0] * m.m[3][3]) - (m.m[0][0] * m.m[2][3] * m.m[3][2])) / A;
+	result.m[1][2] = (-(m.m[0][0] * m.m[1][2] * m.m[3][3]) - (m.m[0][2] * m.m[1][3] * m.m[3][0]) - (m.m[0][3] * m.m[1][0] * m.m[3][2]) + m.m[0][3] * m.m[1][2] * m.m[3][0] + m.m[0][2] * m.m[1][0] * m.m[3][3] + m.m[0][0] * m.m[1][3] * m.m[3][2]) / A;
+	result.m[1][3] = (m.m[0][0] * m.m[1][2] * m.m[2][3] + m.m[0][2] * m.m[1][3] * m.m[2][0] + m.m[0][3] * m.m[1][0] * m.m[2][2] - (m.m[0][3] * m.m[1][2] * m.m[2][0]) - (m.m[0][2] * m.m[1][0] * m.m[2][3]) - (m.m[0][0] * m.m[1][3] * m.m[2][2])) / A;
+	result.m[2][0] = (m.m[1][0] * m.m[2][1] * m.m[3][3] + m.m[1][1] * m.m[2][3] * m.m[3][0] + m.m[1][3] * m.m[2][0] * m.m[3][1] - (m.m[1][3] * m.m[2][1] * m.m[3][0]) - (m.m[1][1] * m.m[2][0] * m.m[3][3]) - (m.m[1][0] * m.m[2][3] * m.m[3][1])) / A;
+	result.m[2][1] = (-(m.m[0][0] * m.m[2][1] * m.m[3][3]) - (m.m[0][1] * m.m[2][3] * m.m[3][0]) - (m.m[0][3] * m.m[2][0] * m.m[3][1]) + m.m[0][3] * m.m[2][1] * m.m[3][0] + m.m[0][1] * m.m[2][0] * m.m[3][3] + m.m[0][0] * m.m[2][3] * m.m[3][1]) / A;
+	result.m[2][2] = (m.m[0][0] * m.m[1][1] * m.m[3][3] + m.m[0][1] * m.m[1][3] * m.m[3][0] + m.m[0][3] * m.m[1][0] * m.m[3][1] - (m.m[0][3] * m.m[1][1] * m.m[3][0]) - (m.m[0][1] * m.m[1][0] * m.m[3][3]) - (m.m[0][0] * m.m[1][3] * m.m[3][1])) / A;
+	result.m[2][3] = (-(m.m[0][0] * m.m[1][1] * m.m[2][3]) - (m.m[0][1] * m.m[1][3] * m.m[2][0]) - (m.m[0][3] * m.m[1][0] * m.m[2][1]) + m.m[0][3] * m.m[1][1] * m.m[2][0] + m.m[0][1] * m.m[1][0] * m.m[2][3] + m.m[0][0] * m.m[1][3] * m.m[2][1]) / A;
+	result.m[3][0] = (-(m.m[1][0] * m.m[2][1] * m.m[3][2]) - (m.m[1][1] * m.m[2][2] * m.m[3][0]) - (m.m[1][2] * m.m[2][0] * m.m[3][1]) + m.m[1][2] * m.m[2][1] * m.m[3][0] + m.m[1][1] * m.m[2][0] * m.m[3][2] + m.m[1][0] * m.m[2][2] * m.m[3][1]) / A;
+	result.m[3][1] = (m.m[0][0] * m.m[2][1] * m.m[3][2] + m.m[0][1] * m.m[2][2] * m.m[3][0] + m.m[0][2] * m.m[2][0] * m.m[3][1] - (m.m[0][2] * m.m[2][1] * m.m[3][0]) - (m.m[0][1] * m.m[2][0] * m.m[3][2]) - (m.m[0][0] * m.m[2][2] * m.m[3][1])) / A;
+	result.m[3][2] = (-(m.m[0][0] * m.m[1][1] * m.m[3][2]) - (m.m[0][1] * m.m[1][2] * m.m[3][0]) - (m.m[0][2] * m.m[1][0] * m.m[3][1]) + m.m[0][2] * m.m[1][1] * m.m[3][0] + m.m[0][1] * m.m[1][0] * m.m[3][2] + m.m[0][0] * m.m[1][2] * m.m[3][1]) / A;
+	result.m[3][3] = (m.m[0][0] * m.m[1][1] * m.m[2][2] + m.m[0][1] * m.m[1][2] * m.m[2][0] + m.m[0][2] * m.m[1][0] * m.m[2][1] - (m.m[0][2] * m.m[1][1] * m.m[2][0]) - (m.m[0][1] * m.m[1][0] * m.m[2][2]) - (m.m[0][0] * m.m[1][2] * m.m[2][1])) / A;
+
+	return result;
+}
+
+#ifndef NDEBUG
+//回転と平行移動だけの行列かどうか(デバッグ時の確認用)
+static bool IsRigidMatrix(const Matrix4x4& m) {
+	const float kEpsilon = 1.0e-4f;
+	if (m.m[0][3] != 0.0f || m.m[1][3] != 0.0f || m.m[2][3] != 0.0f || m.m[3][3] != 1.0f) {
+		return false;
+	}
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			float dot = m.m[i][0] * m.m[j][0] + m.m[i][1] * m.m[j][1] + m.m[i][2] * m.m[j][2];
+			if (std::abs(dot - (i == j ? 1.0f : 0.0f)) > kEpsilon) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+#endif
+
+//逆行列(回転と平行移動だけの行列用)
+Matrix4x4 InverseRigid(const Matrix4x4& m) {
+#ifndef NDEBUG
+	//直交行列でなければ一般の逆行列に任せる
+	if (!IsRigidMatrix(m)) {
+		return Inverse(m);
+	}
+#endif
+	Matrix4x4 result;
+
+	//回転部分は転置
+	result.m[0][0] = m.m[0][0];
+	result.m[0][1] = m.m[1][0];
+	result.m[0][2] = m.m[2][0];
+	result.m[0][3] = 0;
+	result.m[1][0] = m.m[0][1];
+	result.m[1][1] = m.m[1][1];
+	result.m[1][2] = m.m[2][1];
+	result.m[1][3] = 0;
+	result.m[2][0] = m.m[0][2];
+	result.m[2][1] = m.m[1][2];
+	result.m[2][2] = m.m[2][2];
+	result.m[2][3] = 0;
+	//平行移動は -t * R^T
+	result.m[3][0] = -(m.m[3][0] * m.m[0][0] + m.m[3][1] * m.m[0][1] + m.m[3][2] * m.m[0][2]);
+	result.m[3][1] = -(m.m[3][0] * m.m[1][0] + m.m[3][1] * m.m[1][1] + m.m[3][2] * m.m[1][2]);
+	result.m[3][2] = -(m.m[3][0] * m.m[2][0] + m.m[3][1] * m.m[2][1] + m.m[3][2] * m.m[2][2]);
+	result.m[3][3] = 1;
+
+	return result;
+}
+
+//逆行列(アフィン変換行列用)
+Matrix4x4 InverseAffine(const Matrix4x4& m) {
+#ifndef NDEBUG
+	//射影成分があれば一般の逆行列に任せる
+	if (m.m[0][3] != 0.0f || m.m[1][3] != 0.0f || m.m[2][3] != 0.0f || m.m[3][3] != 1.0f) {
+		return Inverse(m);
+	}
+#endif
+	Matrix4x4 result;
+
+	//3x3部分の余因子
+	float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+	float c01 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+	float c02 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+	float determinant = m.m[0][0] * c00 + m.m[0][1] * c01 + m.m[0][2] * c02;
+	assert(determinant != 0.0f);
+	float invDeterminant = 1.0f / determinant;
+
+	result.m[0][0] = c00 * invDeterminant;
+	result.m[0][1] = (m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2]) * invDeterminant;
+	result.m[0][2] = (m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1]) * invDeterminant;
+	result.m[0][3] = 0;
+	result.m[1][0] = c01 * invDeterminant;
+	result.m[1][1] = (m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0]) * invDeterminant;
+	result.m[1][2] = (m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2]) * invDeterminant;
+	result.m[1][3] = 0;
+	result.m[2][0] = c02 * invDeterminant;
+	result.m[2][1] = (m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1]) * invDeterminant;
+	result.m[2][2] = (m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0]) * invDeterminant;
+	result.m[2][3] = 0;
+	//平行移動は -t * A^-1
+	result.m[3][0] = -(m.m[3][0] * result.m[0][0] + m.m[3][1] * result.m[1][0] + m.m[3][2] * result.m[2][0]);
+	result.m[3][1] = -(m.m[3][0] * result.m[0][1] + m.m[3][1] * result.m[1][1] + m.m[3][2] * result.m[2][1]);
+	result.m[3][2] = -(m.m[3][0] * result.m[0][2] + m.m[3][1] * result.m[1][2] + m.m[3][2] * result.m[2][2]);
+	result.m[3][3] = 1;
+
+	return result;
+}
+
+//座標変換
+Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix) {
+	Vector3 result;
+	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
+	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
+	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
+	float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
+	assert(w != 0.0f);
+	result.x /= w;
+	result.y /= w;
+	result.z /= w;
+	return result;
+}
+
+//座標変換(同次座標)
+Vector4 TransformHomogeneous(const Vector3& vector, const Matrix4x4& matrix) {
+	Vector4 result;
+	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0];
+	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1];
+	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2];
+	result.w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + matrix.m[3][3];
+	return result;
+}
+
+//座標変換(アフィン行列用)
+Vector3 TransformPoint(const Vector3& vector, const Matrix4x4& matrix) {
+	Vector3 result;
+	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0];
+	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1];
+	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2];
+	return result;
+}
+
+//方向ベクトルの変換
+Vector3 TransformDirection(const Vector3& vector, const Matrix4x4& matrix) {
+	Vector3 result;
+	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0];
+	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1];
+	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2];
+	return result;
+}
+
+#if defined(MT2_SIMD_X86)
+//行列の各行をSSEレジスタに読み込む
+static void LoadMatrixRows(const Matrix4x4& matrix, __m128 rows[4]) {
+	for (int i = 0; i < 4; ++i) {
+		rows[i] = _mm_loadu_ps(matrix.m[i]);
+	}
+}
+
+//x*row0 + y*row1 + z*row2 (+ row3)
+static __m128 TransformSSE(const Vector3& v, const __m128 rows[4], bool translate) {
+	__m128 result = _mm_mul_ps(_mm_set1_ps(v.x), rows[0]);
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(v.y), rows[1]));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(v.z), rows[2]));
+	if (translate) {
+		result = _mm_add_ps(result, rows[3]);
+	}
+	return result;
+}
+
+//xyzの3要素だけ書き込む(次の要素を壊さないように)
+static void StoreVector3(Vector3& out, __m128 value) {
+	_mm_storel_pi(reinterpret_cast<__m64*>(&out.x), value);
+	_mm_store_ss(&out.z, _mm_movehl_ps(value, value));
+}
+
+static_assert(sizeof(Vector3) == 12, "Vector3 must be three packed floats");
+
+//4点分(12個のfloat)を読み、x,y,zごとのレジスタに並べ替える
+static void LoadVector3x4(const Vector3* in, __m128& x, __m128& y, __m128& z) {
+	const float* p = &in->x;
+	__m128 a = _mm_loadu_ps(p);//x0 y0 z0 x1
+	__m128 b = _mm_loadu_ps(p + 4);//y1 z1 x2 y2
+	__m128 c = _mm_loadu_ps(p + 8);//z2 x3 y3 z3
+	__m128 x01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 0));//x0 x1 y1 z1
+	__m128 x23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));//x2 y2 x3 y3
+	__m128 y01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));//y0 y0 y1 y1
+	__m128 z01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));//z0 z0 z1 z1
+	x = _mm_shuffle_ps(x01, x23, _MM_SHUFFLE(2, 0, 1, 0));
+	y = _mm_shuffle_ps(y01, x23, _MM_SHUFFLE(3, 1, 2, 0));
+	z = _mm_shuffle_ps(z01, c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+//LoadVector3x4の逆(4点分を並べ戻して書き込む)
+static void StoreVector3x4(Vector3* out, __m128 x, __m128 y, __m128 z) {
+	float* p = &out->x;
+	__m128 xy01 = _mm_unpacklo_ps(x, y);//x0 y0 x1 y1
+	__m128 xy23 = _mm_unpackhi_ps(x, y);//x2 y2 x3 y3
+	__m128 zx01 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));//z0 z0 x1 x1
+	__m128 yz1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));//y1 y1 z1 z1
+	__m128 zx23 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));//z2 z2 x3 x3
+	__m128 yz3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));//y3 y3 z3 z3
+	_mm_storeu_ps(p, _mm_shuffle_ps(xy01, zx01, _MM_SHUFFLE(2, 0, 1, 0)));
+	_mm_storeu_ps(p + 4, _mm_shuffle_ps(yz1, xy23, _MM_SHUFFLE(1, 0, 2, 0)));
+	_mm_storeu_ps(p + 8, _mm_shuffle_ps(zx23, yz3, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+//行列の各要素を4つずつ並べたもの(4点をまとめて変換するとき用)
+struct BroadcastMatrix {
+	__m128 m[4][4];
+};
+
+static BroadcastMatrix LoadBroadcastMatrix(const Matrix4x4& matrix) {
+	BroadcastMatrix result;
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 4; ++column) {
+			result.m[row][column] = _mm_set1_ps(matrix.m[row][column]);
+		}
+	}
+	return result;
+}
+
+//4点分のx*m[0][column] + y*m[1][column] + z*m[2][column] (+ m[3][column])
+//足す順番はTransformPointと同じなので、1点ずつ計算した結果と一致する
+static __m128 TransformColumnx4(__m128 x, __m128 y, __m128 z, const BroadcastMatrix& matrix, int column, bool translate) {
+	__m128 result = _mm_mul_ps(x, matrix.m[0][column]);
+	result = _mm_add_ps(result, _mm_mul_ps(y, matrix.m[1][column]));
+	result = _mm_add_ps(result, _mm_mul_ps(z, matrix.m[2][column]));
+	if (translate) {
+		result = _mm_add_ps(result, matrix.m[3][column]);
+	}
+	return result;
+}
+#endif
+
+void TransformPoints(std::span<const Vector3> in, std::span<Vector3> out, const Matrix4x4& matrix) {
+	assert(in.size() == out.size());
+#if defined(MT2_SIMD_X86)
+	//4点ずつx,y,zの並びに入れ替えて変換し、端数は1点ずつ変換する
+	BroadcastMatrix broadcast = LoadBroadcastMatrix(matrix);
+	size_t i = 0;
+	for (; i + 4 <= in.size(); i += 4) {
+		__m128 x, y, z;
+		LoadVector3x4(&in[i], x, y, z);
+		StoreVector3x4(&out[i], TransformColumnx4(x, y, z, broadcast, 0, true), TransformColumnx4(x, y, z, broadcast, 1, true),
+			TransformColumnx4(x, y, z, broadcast, 2, true));
+	}
+	__m128 rows[4];
+	LoadMatrixRows(matrix, rows);
+	for (; i < in.size(); ++i) {
+		StoreVector3(out[i], TransformSSE(in[i], rows, true));
+	}
+#else
+	for (size_t i = 0; i < in.size(); ++i) {
+		out[i] = TransformPoint(in[i], matrix);
+	}
+#endif
+}
+
+void TransformDirections(std::span<const Vector3> in, std::span<Vector3> out, const Matrix4x4& matrix) {
+	assert(in.size() == out.size());
+#if defined(MT2_SIMD_X86)
+	BroadcastMatrix broadcast = LoadBroadcastMatrix(matrix);
+	size_t i = 0;
+	for (; i + 4 <= in.size(); i += 4) {
+		__m128 x, y, z;
+		LoadVector3x4(&in[i], x, y, z);
+		StoreVector3x4(&out[i], TransformColumnx4(x, y, z, broadcast, 0, false), TransformColumnx4(x, y, z, broadcast, 1, false),
+			TransformColumnx4(x, y, z, broadcast, 2, false));
+	}
+	__m128 rows[4];
+	LoadMatrixRows(matrix, rows);
+	for (; i < in.size(); ++i) {
+		StoreVector3(out[i], TransformSSE(in[i], rows, false));
+	}
+#else
+	for (size_t i = 0; i < in.size(); ++i) {
+		out[i] = TransformDirection(in[i], matrix);
+	}
+#endif
+}
+
+void TransformProjectivePoints(std::span<const Vector3> in, std::span<Vector3> out, const Matrix4x4& matrix) {
+	assert(in.size() == out.size());
+#if defined(MT2_SIMD_X86)
+	BroadcastMatrix broadcast = LoadBroadcastMatrix(matrix);
+	size_t i = 0;
+	for (; i + 4 <= in.size(); i += 4) {
+		__m128 x, y, z;
+		LoadVector3x4(&in[i], x, y, z);
+		__m128 w = TransformColumnx4(x, y, z, broadcast, 3, true);
+		assert(_mm_movemask_ps(_mm_cmpeq_ps(w, _mm_setzero_ps())) == 0);
+		StoreVector3x4(&out[i], _mm_div_ps(TransformColumnx4(x, y, z, broadcast, 0, true), w),
+			_mm_div_ps(TransformColumnx4(x, y, z, broadcast, 1, true), w), _mm_div_ps(TransformColumnx4(x, y, z, broadcast, 2, true), w));
+	}
+	__m128 rows[4];
+	LoadMatrixRows(matrix, rows);
+	for (; i < in.size(); ++i) {
+		__m128 result = TransformSSE(in[i], rows, true);
+		__m128 w = _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 3, 3, 3));
+		assert(_mm_cvtss_f32(w) != 0.0f);
+		StoreVector3(out[i], _mm_div_ps(result, w));
+	}
+#else
+	for (size_t i = 0; i < in.size(); ++i) {
+		out[i] = Transform(in[i], matrix);
+	}
+#endif
+}
+
+void TransformHomogeneousPoints(std::span<const Vector3> in, std::span<Vector4> out, const Matrix4x4& matrix) {
+	assert(in.size() == out.size());
+#if defined(MT2_SIMD_X86)
+	__m128 rows[4];
+	LoadMatrixRows(matrix, rows);
+	for (size_t i = 0; i < in.size(); ++i) {
+		_mm_storeu_ps(&out[i].x, TransformSSE(in[i], rows, true));
+	}
+#else
+	for (size_t i = 0; i < in.size(); ++i) {
+		out[i] = TransformHomogeneous(in[i], matrix);
+	}
+#endif
+}
+
+//正規化
+Vector3 Normalize(Vector3 vector) {
+	float lenght;
+	Vector3 result{};
+
+	lenght = sqrtf((vector.x * vector.x) + (vector.y * vector.y) + (vector.z * vector.z));
+	if (lenght != 0) {
+		result.x = vector.x / lenght;
+		result.y = vector.y / lenght;
+		result.z = vector.z / lenght;
+	}
+	return result;
+}
+
+//長さ（ノルム）
+float Length(const Vector3& v) {
+	float result;
+
+	result = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+
+	return result;
+}
+
@@ -0,0 +1,322 @@
+#pragma once
+#include <span>
+#include "ConstexprMath.h"
+
+struct Vector3 {
+	float x;
+	float y;
+	float z;
+};
+struct Vector4 {
+	float x;
+	float y;
+	float z;
+	float w;
+};
+struct Matrix4x4 {
+	float m[4][4];
+};
+
+//X軸回転行列
+constexpr Matrix4x4 MakeRotateXMatrix(float radian);
+//Y軸回転行列
+constexpr Matrix4x4 MakeRotateYMatrix(float radian);
+//Z軸回転行列
+constexpr Matrix4x4 MakeRotateZMatrix(float radian);
+//X→Y→Zの順の回転行列(MakeRotateXMatrix*MakeRotateYMatrix*MakeRotateZMatrixと同じ)
+constexpr Matrix4x4 MakeRotateXYZMatrix(const Vector3& rotate);
+//3次元アフィン変換行列
+constexpr Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
+//逆行列
+Matrix4x4 Inverse(const Matrix4x4& m);
+//逆行列(回転と平行移動だけの行列用。回転部分を転置して平行移動を打ち消す)
+Matrix4x4 InverseRigid(const Matrix4x4& m);
+//逆行列(アフィン変換行列用。3x3部分だけ余因子で逆行列を求める)
+Matrix4x4 InverseAffine(const Matrix4x4& m);
+//投資投影行列
+constexpr Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRadio, float nearClip, float farClip);
+//ビューポート行列
+constexpr Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth);
+//積
+constexpr Matrix4x4 MatrixMultiply(const Matrix4x4& m1, const Matrix4x4& m2);
+//スカラー倍
+constexpr Vector3 Multiply(float scalar, const Vector3 v);
+//座標変換(射影変換。wで割る)
+Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix);
+//座標変換(同次座標のまま返す。wで割らないのでカメラの後ろの点でもよい)
+Vector4 TransformHomogeneous(const Vector3& vector, const Matrix4x4& matrix);
+//座標変換(アフィン行列用。wで割らない)
+Vector3 TransformPoint(const Vector3& vector, const Matrix4x4& matrix);
+//方向ベクトルの変換(平行移動を含めない)
+Vector3 TransformDirection(const Vector3& vector, const Matrix4x4& matrix);
+//まとめて座標変換(inとoutは同じ要素数であること。同じ配列を渡してもよい)
+//x86ではVector3を返すものは4点ずつx,y,zの並びに入れ替えて変換する(TransformHomogeneousPointsは1点ずつ)
+void TransformPoints(std::span<const Vector3> in, std::span<Vector3> out, const Matrix4x4& matrix);
+void TransformDirections(std::span<const Vector3> in, std::span<Vector3> out, const Matrix4x4& matrix);
+void TransformProjectivePoints(std::span<const Vector3> in, std::span<Vector3> out, const Matrix4x4& matrix);
+void TransformHomogeneousPoints(std::span<const Vector3> in, std::span<Vector4> out, const Matrix4x4& matrix);
+//正規化
+Vector3 Normalize(Vector3 vector);
+//長さ
+float Length(const Vector3& v);
+//内積
+constexpr float Dot(const Vector3& v1, const Vector3& v2);
+//クロス積
+constexpr Vector3 Cross(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 Add(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 Subtract(const Vector3& v1, const Vector3& v2);
+
+//ここから下はコンパイル時にも計算できるようにヘッダに置く
+
+//積
+constexpr Matrix4x4 MatrixMultiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+	Matrix4x4 result;
+
+	result.m[0][0] = m1.m[0][0] * m2.m[0][0] + m1.m[0][1] * m2.m[1][0] + m1.m[0][2] * m2.m[2][0] + m1.m[0][3] * m2.m[3][0];
+	result.m[0][1] = m1.m[0][0] * m2.m[0][1] + m1.m[0][1] * m2.m[1][1] + m1.m[0][2] * m2.m[2][1] + m1.m[0][3] * m2.m[3][1];
+	result.m[0][2] = m1.m[0][0] * m2.m[0][2] + m1.m[0][1] * m2.m[1][2] + m1.m[0][2] * m2.m[2][2] + m1.m[0][3] * m2.m[3][2];
+	result.m[0][3] = m1.m[0][0] * m2.m[0][3] + m1.m[0][1] * m2.m[1][3] + m1.m[0][2] * m2.m[2][3] + m1.m[0][3] * m2.m[3][3];
+	result.m[1][0] = m1.m[1][0] * m2.m[0][0] + m1.m[1][1] * m2.m[1][0] + m1.m[1][2] * m2.m[2][0] + m1.m[1][3] * m2.m[3][0];
+	result.m[1][1] = m1.m[1][0] * m2.m[0][1] + m1.m[1][1] * m2.m[1][1] + m1.m[1][2] * m2.m[2][1] + m1.m[1][3] * m2.m[3][1];
+	result.m[1][2] = m1.m[1][0] * m2.m[0][2] + m1.m[1][1] * m2.m[1][2] + m1.m[1][2] * m2.m[2][2] + m1.m[1][3] * m2.m[3][2];
+	result.m[1][3] = m1.m[1][0] * m2.m[0][3] + m1.m[1][1] * m2.m[1][3] + m1.m[1][2] * m2.m[2][3] + m1.m[1][3] * m2.m[3][3];
+	result.m[2][0] = m1.m[2][0] * m2.m[0][0] + m1.m[2][1] * m2.m[1][0] + m1.m[2][2] * m2.m[2][0] + m1.m[2][3] * m2.m[3][0];
+	result.m[2][1] = m1.m[2][0] * m2.m[0][1] + m1.m[2][1] * m2.m[1][1] + m1.m[2][2] * m2.m[2][1] + m1.m[2][3] * m2.m[3][1];
+	result.m[2][2] = m1.m[2][0] * m2.m[0][2] + m1.m[2][1] * m2.m[1][2] + m1.m[2][2] * m2.m[2][2] + m1.m[2][3] * m2.m[3][2];
+	result.m[2][3] = m1.m[2][0] * m2.m[0][3] + m1.m[2][1] * m2.m[1][3] + m1.m[2][2] * m2.m[2][3] + m1.m[2][3] * m2.m[3][3];
+	result.m[3][0] = m1.m[3][0] * m2.m[0][0] + m1.m[3][1] * m2.m[1][0] + m1.m[3][2] * m2.m[2][0] + m1.m[3][3] * m2.m[3][0];
+	result.m[3][1] = m1.m[3][0] * m2.m[0][1] + m1.m[3][1] * m2.m[1][1] + m1.m[3][2] * m2.m[2][1] + m1.m[3][3] * m2.m[3][1];
+	result.m[3][2] = m1.m[3][0] * m2.m[0][2] + m1.m[3][1] * m2.m[1][2] + m1.m[3][2] * m2.m[2][2] + m1.m[3][3] * m2.m[3][2];
+	result.m[3][3] = m1.m[3][0] * m2.m[0][3] + m1.m[3][1] * m2.m[1][3] + m1.m[3][2] * m2.m[2][3] + m1.m[3][3] * m2.m[3][3];
+
+	return result;
+}
+
+//スカラー倍
+constexpr Vector3 Multiply(float scalar, const Vector3 v) {
+	Vector3 result;
+
+	result.x = v.x * scalar;
+	result.y = v.y * scalar;
+	result.z = v.z * scalar;
+
+	return result;
+}
+
+//X軸回転行列
+constexpr Matrix4x4 MakeRotateXMatrix(float radian) {
+	Matrix4x4 result;
+
+	result.m[0][0] = 1;
+	result.m[0][1] = 0;
+	result.m[0][2] = 0;
+	result.m[0][3] = 0;
+	result.m[1][0] = 0;
+	result.m[1][1] = ConstexprCos(radian);
+	result.m[1][2] = ConstexprSin(radian);
+	result.m[1][3] = 0;
+	result.m[2][0] = 0;
+	result.m[2][1] = -ConstexprSin(radian);
+	result.m[2][2] = ConstexprCos(radian);
+	result.m[2][3] = 0;
+	result.m[3][0] = 0;
+	result.m[3][1] = 0;
+	result.m[3][2] = 0;
+	result.m[3][3] = 1;
+
+	return result;
+}
+
+//Y軸回転行列
+constexpr Matrix4x4 MakeRotateYMatrix(float radian) {
+	Matrix4x4 result;
+
+	result.m[0][0] = ConstexprCos(radian);
+	result.m[0][1] = 0;
+	result.m[0][2] = -ConstexprSin(radian);
+	result.m[0][3] = 0;
+	result.m[1][0] = 0;
+	result.m[1][1] = 1;
+	result.m[1][2] = 0;
+	result.m[1][3] = 0;
+	result.m[2][0] = ConstexprSin(radian);
+	result.m[2][1] = 0;
+	result.m[2][2] = ConstexprCos(radian);
+	result.m[2][3] = 0;
+	result.m[3][0] = 0;
+	result.m[3][1] = 0;
+	result.m[3][2] = 0;
+	result.m[3][3] = 1;
+
+	return result;
+}
+
+//Z軸回転行列
+constexpr Matrix4x4 MakeRotateZMatrix(float radian) {
+	Matrix4x4 result;
+
+	result.m[0][0] = ConstexprCos(radian);
+	result.m[0][1] = ConstexprSin(radian);
+	result.m[0][2] = 0;
+	result.m[0][3] = 0;
+	result.m[1][0] = -ConstexprSin(radian);
+	result.m[1][1] = ConstexprCos(radian);
+	result.m[1][2] = 0;
+	result.m[1][3] = 0;
+	result.m[2][0] = 0;
+	result.m[2][1] = 0;
+	result.m[2][2] = 1;
+	result.m[2][3] = 0;
+	result.m[3][0] = 0;
+	result.m[3][1] = 0;
+	result.m[3][2] = 0;
+	result.m[3][3] = 1;
+
+	return result;
+}
+
+//X→Y→Zの順の回転行列(Rx*Ry*Rzを展開した式)
+constexpr Matrix4x4 MakeRotateXYZMatrix(const Vector3& rotate) {
+	Matrix4x4 result;
+
+	//sin/cosは各軸1回だけ
+	float sx = ConstexprSin(rotate.x);
+	float cx = ConstexprCos(rotate.x);
+	float sy = ConstexprSin(rotate.y);
+	float cy = ConstexprCos(rotate.y);
+	float sz = ConstexprSin(rotate.z);
+	float cz = ConstexprCos(rotate.z);
+
+	result.m[0][0] = cy * cz;
+	result.m[0][1] = cy * sz;
+	result.m[0][2] = -sy;
+	result.m[0][3] = 0;
+	result.m[1][0] = sx * sy * cz - cx * sz;
+	result.m[1][1] = sx * sy * sz + cx * cz;
+	result.m[1][2] = sx * cy;
+	result.m[1][3] = 0;
+	result.m[2][0] = cx * sy * cz + sx * sz;
+	result.m[2][1] = cx * sy * sz - sx * cz;
+	result.m[2][2] = cx * cy;
+	result.m[2][3] = 0;
+	result.m[3][0] = 0;
+	result.m[3][1] = 0;
+	result.m[3][2] = 0;
+	result.m[3][3] = 1;
+
+	return result;
+}
+
+//3次元アフィン変換行列
+constexpr Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
+	//回転行列の積は作らず、展開した回転に直接スケールを掛ける
+	Matrix4x4 result = MakeRotateXYZMatrix(rotate);
+
+	result.m[0][0] *= scale.x;
+	result.m[0][1] *= scale.x;
+	result.m[0][2] *= scale.x;
+	result.m[1][0] *= scale.y;
+	result.m[1][1] *= scale.y;
+	result.m[1][2] *= scale.y;
+	result.m[2][0] *= scale.z;
+	result.m[2][1] *= scale.z;
+	result.m[2][2] *= scale.z;
+	result.m[3][0] = translate.x;
+	result.m[3][1] = translate.y;
+	result.m[3][2] = translate.z;
+
+	return result;
+}
+
+//投資投影行列
+constexpr Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRadio, float nearClip, float farClip) {
+	Matrix4x4 result;
+
+	result.m[0][0] = 1 / aspectRadio * (1 / ConstexprTan(fovY / 2));
+	result.m[0][1] = 0;
+	result.m[0][2] = 0;
+	result.m[0][3] = 0;
+	result.m[1][0] = 0;
+	result.m[1][1] = 1 / ConstexprTan(fovY / 2);
+	result.m[1][2] = 0;
+	result.m[1][3] = 0;
+	result.m[2][0] = 0;
+	result.m[2][1] = 0;
+	result.m[2][2] = farClip / (farClip - nearClip);
+	result.m[2][3] = 1;
+	result.m[3][0] = 0;
+	result.m[3][1] = 0;
+	result.m[3][2] = -(nearClip * farClip) / (farClip - nearClip);
+	result.m[3][3] = 0;
+
+	return result;
+}
+
+//ビューポート行列
+constexpr Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth) {
+	Matrix4x4 result;
+
+	result.m[0][0] = width / 2;
+	result.m[0][1] = 0;
+	result.m[0][2] = 0;
+	result.m[0][3] = 0;
+	result.m[1][0] = 0;
+	result.m[1][1] = -(height / 2);
+	result.m[1][2] = 0;
+	result.m[1][3] = 0;
+	result.m[2][0] = 0;
+	result.m[2][1] = 0;
+	result.m[2][2] = maxDepth - minDepth;
+	result.m[2][3] = 0;
+	result.m[3][0] = left + (width / 2);
+	result.m[3][1] = top + (height / 2);
+	result.m[3][2] = minDepth;
+	result.m[3][3] = 1;
+
+	return result;
+}
+
+//内積
+constexpr float Dot(const Vector3& v1, const Vector3& v2) {
+	Vector3 v3;
+	float result;
+
+	v3.x = v1.x * v2.x;
+	v3.y = v1.y * v2.y;
+	v3.z = v1.z * v2.z;
+
+	result = v3.x + v3.y + v3.z;
+
+	return result;
+}
+
+//クロス積
+constexpr Vector3 Cross(const Vector3& v1, const Vector3& v2) {
+	Vector3 result;
+
+	result = { v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x };
+
+	return result;
+}
+
+//加算
+constexpr Vector3 Add(const Vector3& v1, const Vector3& v2) {
+	Vector3 result;
+
+	result.x = v1.x + v2.x;
+	result.y = v1.y + v2.y;
+	result.z = v1.z + v2.z;
+
+	return result;
+}
+
+//減算
+constexpr Vector3 Subtract(const Vector3& v1, const Vector3& v2) {
+	Vector3 result;
+
+	result.x = v1.x - v2.x;
+	result.y = v1.y - v2.y;
+	result.z = v1.z - v2.z;
+
+	return result;
+}
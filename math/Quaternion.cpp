@@ -0,0 +1,150 @@
+#include "Quaternion.h"
+#include <algorithm>
+#include <cmath>
+
+Quaternion IdentityQuaternion() {
+	return { 0.0f,0.0f,0.0f,1.0f };
+}
+
+Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs) {
+	return {
+		lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+		lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+		lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+		lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z,
+	};
+}
+
+Quaternion Conjugate(const Quaternion& quaternion) {
+	return { -quaternion.x,-quaternion.y,-quaternion.z,quaternion.w };
+}
+
+float Dot(const Quaternion& q1, const Quaternion& q2) {
+	return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+}
+
+Quaternion Normalize(const Quaternion& quaternion) {
+	float length = std::sqrt(Dot(quaternion, quaternion));
+	if (length == 0.0f) {
+		return IdentityQuaternion();
+	}
+	float inverseLength = 1.0f / length;
+	return { quaternion.x * inverseLength,quaternion.y * inverseLength,quaternion.z * inverseLength,quaternion.w * inverseLength };
+}
+
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle) {
+	float s = std::sin(angle * 0.5f);
+	return { axis.x * s,axis.y * s,axis.z * s,std::cos(angle * 0.5f) };
+}
+
+Quaternion MakeRotateXYZQuaternion(const Vector3& rotate) {
+	//X軸回転を最初にするので、積はZ*Y*Xの順になる
+	float sx = std::sin(rotate.x * 0.5f);
+	float cx = std::cos(rotate.x * 0.5f);
+	float sy = std::sin(rotate.y * 0.5f);
+	float cy = std::cos(rotate.y * 0.5f);
+	float sz = std::sin(rotate.z * 0.5f);
+	float cz = std::cos(rotate.z * 0.5f);
+	return {
+		sx * cy * cz - cx * sy * sz,
+		cx * sy * cz + sx * cy * sz,
+		cx * cy * sz - sx * sy * cz,
+		cx * cy * cz + sx * sy * sz,
+	};
+}
+
+Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t) {
+	Quaternion end = q1;
+	float dot = Dot(q0, q1);
+	//qと-qは同じ回転なので、近い方へ補間する
+	if (dot < 0.0f) {
+		end = { -q1.x,-q1.y,-q1.z,-q1.w };
+		dot = -dot;
+	}
+	float scale0 = 1.0f - t;
+	float scale1 = t;
+	//角度が小さいときはsinで割ると誤差が大きいので線形補間で近似する
+	if (dot < 0.9995f) {
+		float theta = std::acos(dot);
+		float inverseSin = 1.0f / std::sin(theta);
+		scale0 = std::sin((1.0f - t) * theta) * inverseSin;
+		scale1 = std::sin(t * theta) * inverseSin;
+	}
+	return Normalize({
+		q0.x * scale0 + end.x * scale1,
+		q0.y * scale0 + end.y * scale1,
+		q0.z * scale0 + end.z * scale1,
+		q0.w * scale0 + end.w * scale1 });
+}
+
+float GetRotationAngle(const Quaternion& q0, const Quaternion& q1) {
+	float dot = std::min(std::fabs(Dot(q0, q1)), 1.0f);
+	return 2.0f * std::acos(dot);
+}
+
+Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion) {
+	//v + 2w(u×v) + 2u×(u×v) (uはクォータニオンの虚部)
+	Vector3 u = { quaternion.x,quaternion.y,quaternion.z };
+	Vector3 uv = Cross(u, vector);
+	Vector3 uuv = Cross(u, uv);
+	return {
+		vector.x + 2.0f * (quaternion.w * uv.x + uuv.x),
+		vector.y + 2.0f * (quaternion.w * uv.y + uuv.y),
+		vector.z + 2.0f * (quaternion.w * uv.z + uuv.z),
+	};
+}
+
+Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion) {
+	float x = quaternion.x;
+	float y = quaternion.y;
+	float z = quaternion.z;
+	float w = quaternion.w;
+	Matrix4x4 result;
+
+	result.m[0][0] = 1.0f - 2.0f * (y * y + z * z);
+	result.m[0][1] = 2.0f * (x * y + w * z);
+	result.m[0][2] = 2.0f * (x * z - w * y);
+	result.m[0][3] = 0;
+	result.m[1][0] = 2.0f * (x * y - w * z);
+	result.m[1][1] = 1.0f - 2.0f * (x * x + z * z);
+	result.m[1][2] = 2.0f * (y * z + w * x);
+	result.m[1][3] = 0;
+	result.m[2][0] = 2.0f * (x * z + w * y);
+	result.m[2][1] = 2.0f * (y * z - w * x);
+	result.m[2][2] = 1.0f - 2.0f * (x * x + y * y);
+	result.m[2][3] = 0;
+	result.m[3][0] = 0;
+	result.m[3][1] = 0;
+	result.m[3][2] = 0;
+	result.m[3][3] = 1;
+
+	return result;
+}
+
+void MakeRotateAxes(const Quaternion& quaternion, Vector3 axes[3]) {
+	float x = quaternion.x;
+	float y = quaternion.y;
+	float z = quaternion.z;
+	float w = quaternion.w;
+	//共通の積を先にまとめておく
+	float xx = x * x;
+	float yy = y * y;
+	float zz = z * z;
+	float xy = x * y;
+	float xz = x * z;
+	float yz = y * z;
+	float wx = w * x;
+	float wy = w * y;
+	float wz = w * z;
+	axes[0] = { 1.0f - 2.0f * (yy + zz),2.0f * (xy + wz),2.0f * (xz - wy) };
+	axes[1] = { 2.0f * (xy - wz),1.0f - 2.0f * (xx + zz),2.0f * (yz + wx) };
+	axes[2] = { 2.0f * (xz + wy),2.0f * (yz - wx),1.0f - 2.0f * (xx + yy) };
+}
+
+Quaternion MakeDeltaRotation(const Vector3& angularVelocity, float deltaTime) {
+	float speed = Length(angularVelocity);
+	if (speed == 0.0f) {
+		return IdentityQuaternion();
+	}
+	return MakeRotateAxisAngleQuaternion(Multiply(1.0f / speed, angularVelocity), speed * deltaTime);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "MathFunction.h"
+
+//回転を表す単位クォータニオン(wが実部)
+struct Quaternion {
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+//回転しないクォータニオン
+Quaternion IdentityQuaternion();
+//積(rhsの回転の後にlhsの回転をする)
+Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs);
+//共役(単位クォータニオンなら逆回転)
+Quaternion Conjugate(const Quaternion& quaternion);
+float Dot(const Quaternion& q1, const Quaternion& q2);
+Quaternion Normalize(const Quaternion& quaternion);
+//任意軸回転(axisは正規化済みであること)
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle);
+//X→Y→Zの順の回転(MakeRotateXYZMatrixと同じ回転)
+Quaternion MakeRotateXYZQuaternion(const Vector3& rotate);
+//球面線形補間(近い方の向きで補間する)
+Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+//q0からq1への回転角(0からπ)
+float GetRotationAngle(const Quaternion& q0, const Quaternion& q1);
+//ベクトルを回転させる
+Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion);
+//回転行列(行が回転後の各軸になる)
+Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion);
+//回転後の3軸(MakeRotateMatrixの各行と同じ。行列の残りは作らない)
+void MakeRotateAxes(const Quaternion& quaternion, Vector3 axes[3]);
+//角速度(ラジアン/秒)でdeltaTime秒回す回転(三角関数はここで1回だけ使う)
+Quaternion MakeDeltaRotation(const Vector3& angularVelocity, float deltaTime);
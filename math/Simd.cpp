@@ -0,0 +1,35 @@
+#include "Simd.h"
+#if defined(MT2_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+SimdLevel GetSimdLevel() {
+	static const SimdLevel level = []() {
+#if defined(MT2_SIMD_X86)
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] >= 7) {
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			__cpuidex(info, 7, 0);
+			bool avx2 = (info[1] & (1 << 5)) != 0;
+			//OSがYMMレジスタを保存するか
+			if (osxsave && avx && avx2 && (_xgetbv(0) & 0x6) == 0x6) {
+				return SimdLevel::kAVX2;
+			}
+		}
+#else
+		if (__builtin_cpu_supports("avx2")) {
+			return SimdLevel::kAVX2;
+		}
+#endif
+		//x64ではSSE2が必ず使える
+		return SimdLevel::kSSE;
+#else
+		return SimdLevel::kScalar;
+#endif
+	}();
+	return level;
+}
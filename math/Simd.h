@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define MT2_SIMD_X86
+#include <immintrin.h>
+#endif
+
+//GCC/ClangではAVX2の関数だけ命令セットを指定してコンパイルする(MSVCは指定しなくても使える)
+#if defined(MT2_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MT2_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MT2_TARGET_AVX2
+#endif
+
+//実行環境で使えるSIMD命令
+enum class SimdLevel {
+	kScalar,
+	kSSE,
+	kAVX2,
+};
+
+//CPUが対応しているSIMD命令を調べる(結果はキャッシュされる)
+SimdLevel GetSimdLevel();
@@ -0,0 +1,207 @@
+#pragma once
+#include <span>
+#include "MathFunction.h"
+
+//0と1の位置が決まっている行列
+//Matrix4x4の代わりに使うと、積で決まっている要素の掛け算を省ける(どれもコンパイル時に計算できる)
+
+//アフィン変換行列(4列目が(0,0,0,1)と決まっている。m[3]が平行移動)
+struct AffineMatrix3x4 {
+	float m[4][3];
+};
+
+//3次元アフィン変換行列をまとめて作る(全て同じ要素数であること)
+//3x4の形で直接書き込み、sin/cosは要素ごとに1回ずつ求める(結果はMakeAffineMatrixと同じ)
+void MakeAffineMatrices(std::span<const Vector3> scales, std::span<const Vector3> rotates, std::span<const Vector3> translates, std::span<AffineMatrix3x4> out);
+
+//回転行列(平行移動なし)
+struct RotationMatrix {
+	float m[3][3];
+};
+
+//拡大縮小行列(対角成分だけ)
+struct ScaleMatrix {
+	Vector3 scale;
+};
+
+//ビューポート行列(対角成分と平行移動だけ)
+struct ViewportMatrix {
+	Vector3 scale;
+	Vector3 offset;
+};
+
+//X→Y→Zの順の回転行列(MakeRotateXYZMatrixと同じ)
+constexpr RotationMatrix MakeRotationMatrix(const Vector3& rotate) {
+	Matrix4x4 rotateMatrix = MakeRotateXYZMatrix(rotate);
+	RotationMatrix result;
+	for (int row = 0; row < 3; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			result.m[row][column] = rotateMatrix.m[row][column];
+		}
+	}
+	return result;
+}
+
+constexpr ScaleMatrix MakeScaleMatrix(const Vector3& scale) {
+	return { scale };
+}
+
+//MakeViewportMatrixと同じ変換
+constexpr ViewportMatrix MakeViewportTransform(float left, float top, float width, float height, float minDepth, float maxDepth) {
+	return { { width / 2,-(height / 2),maxDepth - minDepth },{ left + (width / 2),top + (height / 2),minDepth } };
+}
+
+//回転と平行移動から作る
+constexpr AffineMatrix3x4 MakeAffineMatrix3x4(const RotationMatrix& rotate, const Vector3& translate) {
+	AffineMatrix3x4 result;
+	for (int row = 0; row < 3; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			result.m[row][column] = rotate.m[row][column];
+		}
+	}
+	result.m[3][0] = translate.x;
+	result.m[3][1] = translate.y;
+	result.m[3][2] = translate.z;
+	return result;
+}
+
+//4列目を捨てる(アフィン変換行列であること)
+constexpr AffineMatrix3x4 ToAffineMatrix3x4(const Matrix4x4& matrix) {
+	AffineMatrix3x4 result;
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			result.m[row][column] = matrix.m[row][column];
+		}
+	}
+	return result;
+}
+
+constexpr Matrix4x4 ToMatrix4x4(const AffineMatrix3x4& matrix) {
+	Matrix4x4 result;
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			result.m[row][column] = matrix.m[row][column];
+		}
+		result.m[row][3] = row == 3 ? 1.0f : 0.0f;
+	}
+	return result;
+}
+
+constexpr Matrix4x4 ToMatrix4x4(const RotationMatrix& matrix) {
+	return ToMatrix4x4(MakeAffineMatrix3x4(matrix, { 0.0f,0.0f,0.0f }));
+}
+
+constexpr Matrix4x4 ToMatrix4x4(const ScaleMatrix& matrix) {
+	return {
+		matrix.scale.x,0,0,0,
+		0,matrix.scale.y,0,0,
+		0,0,matrix.scale.z,0,
+		0,0,0,1
+	};
+}
+
+constexpr Matrix4x4 ToMatrix4x4(const ViewportMatrix& matrix) {
+	return {
+		matrix.scale.x,0,0,0,
+		0,matrix.scale.y,0,0,
+		0,0,matrix.scale.z,0,
+		matrix.offset.x,matrix.offset.y,matrix.offset.z,1
+	};
+}
+
+//積(回転同士。27回の掛け算)
+constexpr RotationMatrix MatrixMultiply(const RotationMatrix& m1, const RotationMatrix& m2) {
+	RotationMatrix result;
+	for (int row = 0; row < 3; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			result.m[row][column] = m1.m[row][0] * m2.m[0][column] + m1.m[row][1] * m2.m[1][column] + m1.m[row][2] * m2.m[2][column];
+		}
+	}
+	return result;
+}
+
+//積(拡大縮小→回転。行ごとに倍率を掛けるだけで9回)
+constexpr AffineMatrix3x4 MatrixMultiply(const ScaleMatrix& m1, const RotationMatrix& m2) {
+	const float scale[3] = { m1.scale.x,m1.scale.y,m1.scale.z };
+	AffineMatrix3x4 result;
+	for (int row = 0; row < 3; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			result.m[row][column] = scale[row] * m2.m[row][column];
+		}
+	}
+	result.m[3][0] = 0.0f;
+	result.m[3][1] = 0.0f;
+	result.m[3][2] = 0.0f;
+	return result;
+}
+
+//積(アフィン同士。36回)
+constexpr AffineMatrix3x4 MatrixMultiply(const AffineMatrix3x4& m1, const AffineMatrix3x4& m2) {
+	AffineMatrix3x4 result;
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			result.m[row][column] = m1.m[row][0] * m2.m[0][column] + m1.m[row][1] * m2.m[1][column] + m1.m[row][2] * m2.m[2][column];
+		}
+	}
+	//平行移動の行は4列目の1を掛けたものを足す
+	for (int column = 0; column < 3; ++column) {
+		result.m[3][column] += m2.m[3][column];
+	}
+	return result;
+}
+
+//積(ワールド行列×ビュー射影行列など。48回)
+constexpr Matrix4x4 MatrixMultiply(const AffineMatrix3x4& m1, const Matrix4x4& m2) {
+	Matrix4x4 result;
+	for (int column = 0; column < 4; ++column) {
+		for (int row = 0; row < 3; ++row) {
+			result.m[row][column] = m1.m[row][0] * m2.m[0][column] + m1.m[row][1] * m2.m[1][column] + m1.m[row][2] * m2.m[2][column];
+		}
+		result.m[3][column] = m1.m[3][0] * m2.m[0][column] + m1.m[3][1] * m2.m[1][column] + m1.m[3][2] * m2.m[2][column] + m2.m[3][column];
+	}
+	return result;
+}
+
+//積(拡大縮小×任意の行列。行ごとに倍率を掛けるだけで12回)
+constexpr Matrix4x4 MatrixMultiply(const ScaleMatrix& m1, const Matrix4x4& m2) {
+	const float scale[3] = { m1.scale.x,m1.scale.y,m1.scale.z };
+	Matrix4x4 result = m2;
+	for (int row = 0; row < 3; ++row) {
+		for (int column = 0; column < 4; ++column) {
+			result.m[row][column] *= scale[row];
+		}
+	}
+	return result;
+}
+
+//積(任意の行列×ビューポート行列。24回)
+constexpr Matrix4x4 MatrixMultiply(const Matrix4x4& m1, const ViewportMatrix& m2) {
+	const float scale[3] = { m2.scale.x,m2.scale.y,m2.scale.z };
+	const float offset[3] = { m2.offset.x,m2.offset.y,m2.offset.z };
+	Matrix4x4 result;
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			result.m[row][column] = m1.m[row][column] * scale[column] + m1.m[row][3] * offset[column];
+		}
+		result.m[row][3] = m1.m[row][3];
+	}
+	return result;
+}
+
+//座標変換(9回)
+constexpr Vector3 TransformPoint(const Vector3& vector, const AffineMatrix3x4& matrix) {
+	return {
+		vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0],
+		vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1],
+		vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2],
+	};
+}
+
+//座標変換(3回)
+constexpr Vector3 TransformPoint(const Vector3& vector, const ViewportMatrix& matrix) {
+	return {
+		vector.x * matrix.scale.x + matrix.offset.x,
+		vector.y * matrix.scale.y + matrix.offset.y,
+		vector.z * matrix.scale.z + matrix.offset.z,
+	};
+}
@@ -0,0 +1,76 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+#if defined(MT2_FRAME_ARENA_POISON)
+static const uint8_t kAllocatedPoison = 0xCD;//確保したが書いていない
+static const uint8_t kFreedPoison = 0xDD;//解放済み
+#endif
+
+static size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void FrameArena::AlignedDelete::operator()(uint8_t* block) const {
+	::operator delete[](block, std::align_val_t(kBlockAlignment));
+}
+
+FrameArena::Block FrameArena::AllocateBlock(size_t size) {
+	++heapAllocationCount_;
+	return Block(static_cast<uint8_t*>(::operator new[](std::max<size_t>(size, 1), std::align_val_t(kBlockAlignment))));
+}
+
+FrameArena::FrameArena(size_t capacity) {
+	capacity_ = AlignUp(capacity, kBlockAlignment);
+	buffer_ = AllocateBlock(capacity_);
+	//最初の確保はフレームの外なので数えない
+	heapAllocationCount_ = 0;
+#if defined(MT2_FRAME_ARENA_POISON)
+	std::memset(buffer_.get(), kFreedPoison, capacity_);
+#endif
+}
+
+FrameArena::~FrameArena() = default;
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	//ブロックは64バイト境界なので、それより大きな境界には合わせられない
+	assert(alignment <= kBlockAlignment);
+	size_t begin = AlignUp(offset_, alignment);
+	uint8_t* pointer = nullptr;
+	if (begin + size <= capacity_) {
+		pointer = buffer_.get() + begin;
+		offset_ = begin + size;
+	}
+	else {
+		//入りきらない分は別に確保して、このフレームの終わりまで持っておく
+		overflowBlocks_.push_back(AllocateBlock(size));
+		overflowBytes_ += size;
+		pointer = overflowBlocks_.back().get();
+	}
+#if defined(MT2_FRAME_ARENA_POISON)
+	std::memset(pointer, kAllocatedPoison, size);
+#endif
+	return pointer;
+}
+
+void FrameArena::EndFrame() {
+	lastFrameUsed_ = GetUsed();
+	highWater_ = std::max(highWater_, lastFrameUsed_);
+#if defined(MT2_FRAME_ARENA_POISON)
+	//解放した領域を読むと一目で分かるようにする
+	std::memset(buffer_.get(), kFreedPoison, offset_);
+#endif
+	if (!overflowBlocks_.empty()) {
+		//次のフレームからはあふれないように、最大使用量に余裕を持たせて広げる
+		overflowBlocks_.clear();
+		overflowBytes_ = 0;
+		capacity_ = AlignUp(highWater_ + highWater_ / 2, kBlockAlignment);
+		buffer_ = AllocateBlock(capacity_);
+#if defined(MT2_FRAME_ARENA_POISON)
+		std::memset(buffer_.get(), kFreedPoison, capacity_);
+#endif
+	}
+	offset_ = 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+//デバッグビルドでは解放した領域と確保した直後の領域を決まった値で埋める
+#if !defined(MT2_FRAME_ARENA_POISON) && !defined(NDEBUG)
+#define MT2_FRAME_ARENA_POISON
+#endif
+
+//1フレームだけ使う一時バッファ用の線形アロケータ
+//EndFrameで全て解放する(デストラクタは呼ばないので、中身は自明に破棄できる型に限る)
+//容量を超えた分は個別にヒープから確保し、次のEndFrameで最大使用量に合わせて容量を広げる
+class FrameArena {
+public:
+	explicit FrameArena(size_t capacity);
+	~FrameArena();
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	//alignmentは2のべき乗でkBlockAlignment以下
+	void* Allocate(size_t size, size_t alignment);
+	//要素は初期化しない
+	template<class T>
+	std::span<T> AllocateSpan(size_t count) {
+		static_assert(std::is_trivially_destructible_v<T>, "FrameArena does not run destructors");
+		static_assert(alignof(T) <= kBlockAlignment, "FrameArena cannot align beyond kBlockAlignment");
+		return { static_cast<T*>(Allocate(count * sizeof(T), alignof(T))),count };
+	}
+	template<class T>
+	std::span<T> CopySpan(std::span<const T> source) {
+		std::span<T> copy = AllocateSpan<T>(source.size());
+		if (!source.empty()) {
+			std::memcpy(copy.data(), source.data(), source.size_bytes());
+		}
+		return copy;
+	}
+
+	//このフレームで確保したものを全て解放する(以前に返した領域は使えなくなる)
+	void EndFrame();
+
+	size_t GetCapacity() const { return capacity_; }
+	//このフレームで確保したバイト数(あふれた分も含む)
+	size_t GetUsed() const { return offset_ + overflowBytes_; }
+	//直前のフレームで使ったバイト数
+	size_t GetLastFrameUsed() const { return lastFrameUsed_; }
+	//これまでのフレームで一番多く使ったバイト数
+	size_t GetHighWater() const { return highWater_; }
+	//ヒープから確保した回数(容量が足りていればフレームをまたいで増えない)
+	uint64_t GetHeapAllocationCount() const { return heapAllocationCount_; }
+
+	static constexpr size_t kBlockAlignment = 64;
+
+private:
+	struct AlignedDelete {
+		void operator()(uint8_t* block) const;
+	};
+	using Block = std::unique_ptr<uint8_t[], AlignedDelete>;
+	Block AllocateBlock(size_t size);
+
+	Block buffer_;
+	size_t capacity_ = 0;
+	size_t offset_ = 0;
+	std::vector<Block> overflowBlocks_;
+	size_t overflowBytes_ = 0;
+	size_t lastFrameUsed_ = 0;
+	size_t highWater_ = 0;
+	uint64_t heapAllocationCount_ = 0;
+};
@@ -0,0 +1,151 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+static uint64_t SteadyNowNs() {
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//tickの基準を取ってから少し待ち、最初の換算比を求めておく
+static const uint64_t kCalibrationNs = 1000000;
+
+Profiler& Profiler::Get() {
+	static Profiler profiler;
+	return profiler;
+}
+
+Profiler::Profiler() {
+	epochTicks_ = ReadTicks();
+	epochClockNs_ = SteadyNowNs();
+	while (SteadyNowNs() - epochClockNs_ < kCalibrationNs) {
+	}
+	Calibrate();
+	SetFrameCapacity(120);
+}
+
+void Profiler::Calibrate() {
+	//基準からの時間が長いほど換算比が正確になるので、フレームが終わるたびに求め直す
+	uint64_t ticks = ReadTicks();
+	uint64_t clockNs = SteadyNowNs();
+	if (ticks > epochTicks_ && clockNs > epochClockNs_) {
+		nsPerTick_ = double(clockNs - epochClockNs_) / double(ticks - epochTicks_);
+	}
+}
+
+void Profiler::SetFrameCapacity(size_t frameCapacity) {
+	assert(!inFrame_);
+	frames_.assign(std::max<size_t>(frameCapacity, 1), ProfileFrame{});
+	frameCount_ = 0;
+	nextFrame_ = 0;
+}
+
+void Profiler::BeginFrame() {
+	assert(!inFrame_);
+	ProfileFrame& frame = frames_[nextFrame_];
+	frame.index = frameIndex_++;
+	frame.startNs = ReadTicks();
+	frame.durationNs = 0;
+	//前に使ったフレームの容量はそのまま使い回す
+	frame.events.clear();
+	frame.droppedCount = 0;
+	frameThread_ = std::this_thread::get_id();
+	depth_ = 0;
+	inFrame_ = true;
+}
+
+void Profiler::EndFrame() {
+	assert(inFrame_);
+	ProfileFrame& frame = frames_[nextFrame_];
+	uint64_t endTicks = ReadTicks();
+	Calibrate();
+	//記録中はtickのまま持っておき、ここでまとめてナノ秒に直す
+	for (ProfileEvent& event : frame.events) {
+		uint64_t endNs = TicksToNs(event.startNs + event.durationNs);
+		event.startNs = TicksToNs(event.startNs);
+		event.durationNs = endNs - event.startNs;
+	}
+	frame.startNs = TicksToNs(frame.startNs);
+	frame.durationNs = TicksToNs(endTicks) - frame.startNs;
+	inFrame_ = false;
+	nextFrame_ = (nextFrame_ + 1) % frames_.size();
+	frameCount_ = std::min(frameCount_ + 1, frames_.size());
+}
+
+void Profiler::EndScope(const char* name, uint64_t startTicks, uint32_t depth) {
+	uint64_t endTicks = ReadTicks();
+	depth_ = depth;
+	//区間の途中でフレームが終わった場合は捨てる
+	if (!inFrame_) {
+		return;
+	}
+	ProfileFrame& frame = frames_[nextFrame_];
+	if (frame.events.size() >= maxEventsPerFrame_) {
+		++frame.droppedCount;
+		return;
+	}
+	frame.events.push_back({ name,startTicks,endTicks - startTicks,depth });
+}
+
+const ProfileFrame& Profiler::GetFrame(size_t ago) const {
+	assert(ago < frameCount_);
+	return frames_[(nextFrame_ + frames_.size() - 1 - ago) % frames_.size()];
+}
+
+const char* Profiler::InternName(std::string_view name) {
+	for (const std::string& interned : internedNames_) {
+		if (interned == name) {
+			return interned.c_str();
+		}
+	}
+	//dequeは要素を動かさないのでポインタが無効にならない
+	internedNames_.emplace_back(name);
+	return internedNames_.back().c_str();
+}
+
+//JSONの文字列として書き出す
+static void WriteJsonString(FILE* file, const char* text) {
+	std::fputc('"', file);
+	for (const char* c = text; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			std::fputc('\\', file);
+			std::fputc(*c, file);
+		}
+		else if (static_cast<unsigned char>(*c) < 0x20) {
+			std::fprintf(file, "\\u%04x", unsigned(static_cast<unsigned char>(*c)));
+		}
+		else {
+			std::fputc(*c, file);
+		}
+	}
+	std::fputc('"', file);
+}
+
+void Profiler::WriteChromeTrace(FILE* file) const {
+	//時刻はマイクロ秒。古いフレームから順に書く
+	std::fprintf(file, "{\"traceEvents\":[\n");
+	bool first = true;
+	for (size_t ago = frameCount_; ago-- > 0;) {
+		const ProfileFrame& frame = GetFrame(ago);
+		std::fprintf(file, "%s{\"name\":\"frame %llu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+			first ? "" : ",\n", (unsigned long long)frame.index, double(frame.startNs) * 1.0e-3, double(frame.durationNs) * 1.0e-3);
+		first = false;
+		for (const ProfileEvent& event : frame.events) {
+			std::fprintf(file, ",\n{\"name\":");
+			WriteJsonString(file, event.name);
+			std::fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+				double(event.startNs) * 1.0e-3, double(event.durationNs) * 1.0e-3);
+		}
+	}
+	std::fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+bool Profiler::WriteChromeTrace(const char* path) const {
+	FILE* file = std::fopen(path, "w");
+	if (!file) {
+		return false;
+	}
+	WriteChromeTrace(file);
+	std::fclose(file);
+	return true;
+}
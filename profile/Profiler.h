@@ -0,0 +1,133 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "Simd.h"
+#if defined(MT2_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(MT2_SIMD_X86)
+#include <x86intrin.h>
+#endif
+
+//計測した区間
+struct ProfileEvent {
+	const char* name;//文字列リテラルかInternNameで作った名前
+	uint64_t startNs;
+	uint64_t durationNs;
+	uint32_t depth;//入れ子の深さ(0が一番外側)
+};
+
+//1フレーム分の計測結果
+struct ProfileFrame {
+	uint64_t index;
+	uint64_t startNs;
+	uint64_t durationNs;
+	std::vector<ProfileEvent> events;//区間が終わった順(フレームの途中は時刻がtickのまま入っている)
+	uint32_t droppedCount;//1フレームの上限を超えて捨てた区間の数
+};
+
+//フレームごとの区間の計測結果をリングバッファに溜める
+//BeginFrameを呼んだスレッドの区間だけを記録する(ワーカースレッドの区間は無視する)
+class Profiler {
+public:
+	static Profiler& Get();
+
+	//溜めておくフレーム数(古いものから上書きする)
+	void SetFrameCapacity(size_t frameCapacity);
+	//1フレームに記録する区間の上限
+	void SetMaxEventsPerFrame(size_t maxEvents) { maxEventsPerFrame_ = maxEvents; }
+
+	void BeginFrame();
+	void EndFrame();
+
+	//区間の開始。記録しない場合はfalseを返す
+	bool BeginScope(uint64_t& startTicks, uint32_t& depth) {
+		if (!inFrame_ || std::this_thread::get_id() != frameThread_) {
+			return false;
+		}
+		depth = depth_++;
+		startTicks = ReadTicks();
+		return true;
+	}
+	void EndScope(const char* name, uint64_t startTicks, uint32_t depth);
+
+	//x86ではrdtsc、それ以外ではsteady_clockの値(単位は環境による)
+	static uint64_t ReadTicks();
+	//計測の基準時刻からの経過時間
+	uint64_t Now() const { return TicksToNs(ReadTicks()); }
+
+	//終わったフレームの数(最大でSetFrameCapacityの数)
+	size_t GetFrameCount() const { return frameCount_; }
+	//ago番前に終わったフレーム(0が最新)
+	const ProfileFrame& GetFrame(size_t ago) const;
+
+	//実行時に作った名前を区間の名前として使えるように保持する
+	const char* InternName(std::string_view name);
+
+	//Chromeのトレース形式(chrome://tracing、Perfetto)で書き出す
+	void WriteChromeTrace(FILE* file) const;
+	bool WriteChromeTrace(const char* path) const;
+
+private:
+	Profiler();
+	uint64_t TicksToNs(uint64_t ticks) const { return uint64_t(double(ticks - epochTicks_) * nsPerTick_); }
+	void Calibrate();
+
+	std::vector<ProfileFrame> frames_;
+	size_t frameCount_ = 0;
+	size_t nextFrame_ = 0;
+	uint64_t frameIndex_ = 0;
+	size_t maxEventsPerFrame_ = 8192;
+	bool inFrame_ = false;
+	uint32_t depth_ = 0;
+	std::thread::id frameThread_;
+	std::deque<std::string> internedNames_;
+	uint64_t epochTicks_ = 0;
+	uint64_t epochClockNs_ = 0;
+	double nsPerTick_ = 1.0;
+};
+
+inline uint64_t Profiler::ReadTicks() {
+#if defined(MT2_SIMD_X86)
+	//steady_clockの半分ほどの時間で読める
+	return __rdtsc();
+#else
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+//スコープを抜けるまでの時間を計測する
+class ProfileScope {
+public:
+	explicit ProfileScope(const char* name) : name_(name) {
+		active_ = Profiler::Get().BeginScope(startTicks_, depth_);
+	}
+	~ProfileScope() {
+		if (active_) {
+			Profiler::Get().EndScope(name_, startTicks_, depth_);
+		}
+	}
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* name_;
+	uint64_t startTicks_ = 0;
+	uint32_t depth_ = 0;
+	bool active_ = false;
+};
+
+//MT2_DISABLE_PROFILERを定義すると計測のコードは全て消える
+#if defined(MT2_DISABLE_PROFILER)
+#define MT2_PROFILE_SCOPE(name) ((void)0)
+#else
+#define MT2_PROFILE_CONCAT_INNER(a, b) a##b
+#define MT2_PROFILE_CONCAT(a, b) MT2_PROFILE_CONCAT_INNER(a, b)
+#define MT2_PROFILE_SCOPE(name) ProfileScope MT2_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#endif
@@ -0,0 +1,102 @@
+#include "DebugLines.h"
+#include <vector>
+#include "LineClip.h"
+#include "StructuredMatrix.h"
+
+void AddGridLines(LineBatch& batch, const GridLineCache& grid, uint32_t color, uint32_t centerColor) {
+	const std::vector<Vector3>& vertices = grid.GetScreenVertices();
+	for (uint32_t lineIndex = 0; lineIndex < uint32_t(vertices.size() / 2); ++lineIndex) {
+		if (!grid.IsLineVisible(lineIndex)) {
+			continue;
+		}
+		batch.AddLine(vertices[lineIndex * 2], vertices[lineIndex * 2 + 1], grid.IsCenterLine(lineIndex) ? centerColor : color);
+	}
+}
+
+//OBBの8頂点のローカル座標の符号(sizeに掛ける)
+enum { kRTF, kLTF, kRDF, kLDF, kRTB, kLTB, kRDB, kLDB };
+static const float kCornerSigns[8][3] = {
+	{ -1.0f, 1.0f,-1.0f },//右上前
+	{ 1.0f, 1.0f,-1.0f },//左上前
+	{ -1.0f,-1.0f,-1.0f },//右下前
+	{ 1.0f,-1.0f,-1.0f },//左下前
+	{ -1.0f, 1.0f, 1.0f },//右上後ろ
+	{ 1.0f, 1.0f, 1.0f },//左上後ろ
+	{ -1.0f,-1.0f, 1.0f },//右下後ろ
+	{ 1.0f,-1.0f, 1.0f },//左下後ろ
+};
+static const int kEdges[12][2] = {
+	{ kRTF,kLTF },{ kRDF,kLDF },{ kRTB,kLTB },{ kRDB,kLDB },
+	{ kRTF,kRTB },{ kLTF,kLTB },{ kRDF,kRDB },{ kLDF,kLDB },
+	{ kRTF,kRDF },{ kLTF,kLDF },{ kRTB,kRDB },{ kLTB,kLDB },
+};
+
+//クリップ空間の8頂点から12辺を追加する
+static void AddClipBoxEdges(LineBatch& batch, const Vector4* clipVertices, const Matrix4x4& viewportMatrix, uint32_t color) {
+	for (const auto& edge : kEdges) {
+		Vector3 start;
+		Vector3 end;
+		if (ProjectClipLine(clipVertices[edge[0]], clipVertices[edge[1]], viewportMatrix, start, end)) {
+			batch.AddLine(start, end, color);
+		}
+	}
+}
+
+void AddOBBLines(LineBatch& batch, const OBB& obb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color) {
+	Vector3 vertices[8];
+	for (int corner = 0; corner < 8; ++corner) {
+		vertices[corner] = { kCornerSigns[corner][0] * obb.size.x,kCornerSigns[corner][1] * obb.size.y,kCornerSigns[corner][2] * obb.size.z };
+	}
+
+	//ワールド行列の4列目は(0,0,0,1)なので、その分の掛け算を省く
+	AffineMatrix3x4 obbworldMatrix = {
+		obb.orientations[0].x,obb.orientations[0].y,obb.orientations[0].z,
+		obb.orientations[1].x,obb.orientations[1].y,obb.orientations[1].z,
+		obb.orientations[2].x,obb.orientations[2].y,obb.orientations[2].z,
+		obb.center.x,obb.center.y,obb.center.z
+	};
+
+	Matrix4x4 worldViewProjectionMatrix = MatrixMultiply(obbworldMatrix, viewProjectionMatrix);
+
+	//8頂点をまとめてクリップ空間まで変換する(wで割るのは辺をニアクリップ面で切った後)
+	Vector4 clipVertices[8];
+	TransformHomogeneousPoints(vertices, clipVertices, worldViewProjectionMatrix);
+	AddClipBoxEdges(batch, clipVertices, viewportMatrix, color);
+}
+
+void AddOBBLines(LineBatch& batch, const OBBSoAView& obbs, std::span<const uint32_t> indices, const Matrix4x4& viewProjectionMatrix,
+	const Matrix4x4& viewportMatrix, uint32_t color, FrameArena& arena) {
+	//全てのOBBの頂点をワールド座標で並べてから、1回でクリップ空間に変換する
+	std::span<Vector3> worldVertices = arena.AllocateSpan<Vector3>(indices.size() * 8);
+	std::span<Vector4> clipVertices = arena.AllocateSpan<Vector4>(indices.size() * 8);
+	for (size_t i = 0; i < indices.size(); ++i) {
+		const uint32_t index = indices[i];
+		const float size[3] = { obbs.sizeX[index],obbs.sizeY[index],obbs.sizeZ[index] };
+		float axes[3][3];//sizeを掛けた軸
+		for (int axis = 0; axis < 3; ++axis) {
+			for (int component = 0; component < 3; ++component) {
+				axes[axis][component] = obbs.orientations[axis][component][index] * size[axis];
+			}
+		}
+		for (int corner = 0; corner < 8; ++corner) {
+			const float* signs = kCornerSigns[corner];
+			worldVertices[i * 8 + corner] = {
+				obbs.centerX[index] + signs[0] * axes[0][0] + signs[1] * axes[1][0] + signs[2] * axes[2][0],
+				obbs.centerY[index] + signs[0] * axes[0][1] + signs[1] * axes[1][1] + signs[2] * axes[2][1],
+				obbs.centerZ[index] + signs[0] * axes[0][2] + signs[1] * axes[1][2] + signs[2] * axes[2][2],
+			};
+		}
+	}
+	TransformHomogeneousPoints(worldVertices, clipVertices, viewProjectionMatrix);
+	for (size_t i = 0; i < indices.size(); ++i) {
+		AddClipBoxEdges(batch, &clipVertices[i * 8], viewportMatrix, color);
+	}
+}
+
+void AddLine3D(LineBatch& batch, const Vector3& start, const Vector3& end, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color) {
+	Vector3 screenStart;
+	Vector3 screenEnd;
+	if (ProjectLine(start, end, viewProjectionMatrix, viewportMatrix, screenStart, screenEnd)) {
+		batch.AddLine(screenStart, screenEnd, color);
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "Collision.h"
+#include "FrameArena.h"
+#include "GridLineCache.h"
+#include "LineBatch.h"
+#include "MathFunction.h"
+
+//グリッド線を追加する(画面に映らない線は追加しない)
+void AddGridLines(LineBatch& batch, const GridLineCache& grid, uint32_t color, uint32_t centerColor);
+//OBBの12辺を追加する(辺はニアクリップ面で切る)
+void AddOBBLines(LineBatch& batch, const OBB& obb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+//indicesで選んだOBBの辺をまとめて追加する(頂点の一時バッファはarenaから取る)
+void AddOBBLines(LineBatch& batch, const OBBSoAView& obbs, std::span<const uint32_t> indices, const Matrix4x4& viewProjectionMatrix,
+	const Matrix4x4& viewportMatrix, uint32_t color, FrameArena& arena);
+//ワールド座標の線分を追加する(カメラの後ろの部分は切り捨てる)
+void AddLine3D(LineBatch& batch, const Vector3& start, const Vector3& end, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
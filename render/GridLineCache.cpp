@@ -0,0 +1,63 @@
+#include "GridLineCache.h"
+#include <cstring>
+#include "LineClip.h"
+#include "Profiler.h"
+
+GridLineCache::GridLineCache(float halfWidth, uint32_t subdivision)
+	: halfWidth_(halfWidth), subdivision_(subdivision) {
+	BuildWorldVertices();
+}
+
+void GridLineCache::SetParameters(float halfWidth, uint32_t subdivision) {
+	if (halfWidth == halfWidth_ && subdivision == subdivision_) {
+		return;
+	}
+	halfWidth_ = halfWidth;
+	subdivision_ = subdivision;
+	BuildWorldVertices();
+}
+
+void GridLineCache::BuildWorldVertices() {
+	const float kGridEvery = (halfWidth_ * 2.0f) / float(subdivision_);//一つ分の長さ
+	worldVertices_.clear();
+	worldVertices_.reserve((subdivision_ + 1) * 4);
+
+	//奥から手前への線
+	for (uint32_t xIndex = 0; xIndex <= subdivision_; ++xIndex) {
+		worldVertices_.push_back({ float(xIndex) * kGridEvery - halfWidth_, 0, halfWidth_ });
+		worldVertices_.push_back({ float(xIndex) * kGridEvery - halfWidth_, 0, -halfWidth_ });
+	}
+	//左から右への線
+	for (uint32_t zIndex = 0; zIndex <= subdivision_; ++zIndex) {
+		worldVertices_.push_back({ halfWidth_, 0, float(zIndex) * kGridEvery - halfWidth_ });
+		worldVertices_.push_back({ -halfWidth_, 0, float(zIndex) * kGridEvery - halfWidth_ });
+	}
+	clipVertices_.resize(worldVertices_.size());
+	screenVertices_.resize(worldVertices_.size());
+	lineVisible_.resize(worldVertices_.size() / 2);
+	dirty_ = true;
+}
+
+void GridLineCache::Update(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix) {
+	MT2_PROFILE_SCOPE("GridLineCache::Update");
+	if (!dirty_ &&
+		std::memcmp(&viewProjectionMatrix, &cachedViewProjectionMatrix_, sizeof(Matrix4x4)) == 0 &&
+		std::memcmp(&viewportMatrix, &cachedViewportMatrix_, sizeof(Matrix4x4)) == 0) {
+		return;
+	}
+	cachedViewProjectionMatrix_ = viewProjectionMatrix;
+	cachedViewportMatrix_ = viewportMatrix;
+	dirty_ = false;
+
+	//カメラの後ろに回る線もあるので、クリップ空間でニアクリップ面に切ってからwで割る
+	TransformHomogeneousPoints(worldVertices_, clipVertices_, viewProjectionMatrix);
+	for (size_t lineIndex = 0; lineIndex < lineVisible_.size(); ++lineIndex) {
+		lineVisible_[lineIndex] = ProjectClipLine(clipVertices_[lineIndex * 2], clipVertices_[lineIndex * 2 + 1], viewportMatrix,
+			screenVertices_[lineIndex * 2], screenVertices_[lineIndex * 2 + 1]) ? 1 : 0;
+	}
+}
+
+bool GridLineCache::IsCenterLine(uint32_t lineIndex) const {
+	//分割数が偶数のときだけ原点を通る線がある
+	return subdivision_ % 2 == 0 && lineIndex % (subdivision_ + 1) == subdivision_ / 2;
+}
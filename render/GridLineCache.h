@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "MathFunction.h"
+
+//グリッド線の頂点キャッシュ
+//ワールド座標の頂点は一度だけ作り、スクリーン座標は行列が変わったときだけ計算し直す
+class GridLineCache {
+public:
+	GridLineCache(float halfWidth, uint32_t subdivision);
+	//グリッドの半分の幅と分割数を変える
+	void SetParameters(float halfWidth, uint32_t subdivision);
+	void Update(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix);
+
+	//線ごとに始点・終点の順で並んだスクリーン座標(ニアクリップ面で切った後の座標)
+	const std::vector<Vector3>& GetScreenVertices() const { return screenVertices_; }
+	//線が画面に映るか(映らない線のスクリーン座標は使わないこと)
+	bool IsLineVisible(uint32_t lineIndex) const { return lineVisible_[lineIndex] != 0; }
+	//中心線かどうか
+	bool IsCenterLine(uint32_t lineIndex) const;
+	float GetHalfWidth() const { return halfWidth_; }
+	uint32_t GetSubdivision() const { return subdivision_; }
+
+private:
+	void BuildWorldVertices();
+
+	float halfWidth_;
+	uint32_t subdivision_;
+	std::vector<Vector3> worldVertices_;
+	std::vector<Vector4> clipVertices_;
+	std::vector<Vector3> screenVertices_;
+	std::vector<uint8_t> lineVisible_;
+	Matrix4x4 cachedViewProjectionMatrix_{};
+	Matrix4x4 cachedViewportMatrix_{};
+	bool dirty_ = true;
+};
@@ -0,0 +1,105 @@
+#include "LineBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "Profiler.h"
+
+//向きによらない線のハッシュ(端点は並べ替え済みであること)
+static uint32_t HashLine(const LineVertex& a, const LineVertex& b, uint32_t color) {
+	uint32_t hash = 2166136261u;
+	const uint32_t values[5] = { uint32_t(a.x),uint32_t(a.y),uint32_t(b.x),uint32_t(b.y),color };
+	for (uint32_t value : values) {
+		hash = (hash ^ value) * 16777619u;
+	}
+	return hash ^ (hash >> 15);
+}
+
+static bool LessVertex(const LineVertex& a, const LineVertex& b) {
+	return a.x != b.x ? a.x < b.x : a.y < b.y;
+}
+
+LineBatch::LineBatch() {
+	slots_.assign(256, Slot{ 0,0 });
+}
+
+void LineBatch::Clear() {
+	vertices_.clear();
+	colors_.clear();
+	duplicateCount_ = 0;
+	//表は消さずに世代を進める(一周したときだけ消す)
+	if (++stamp_ == 0) {
+		std::fill(slots_.begin(), slots_.end(), Slot{ 0,0 });
+		stamp_ = 1;
+	}
+}
+
+void LineBatch::AddLine(const Vector3& start, const Vector3& end, uint32_t color) {
+	AddLine(int32_t(start.x), int32_t(start.y), int32_t(end.x), int32_t(end.y), color);
+}
+
+bool LineBatch::IsSameLine(uint32_t lineIndex, const LineVertex& a, const LineVertex& b, uint32_t color) const {
+	if (colors_[lineIndex] != color) {
+		return false;
+	}
+	LineVertex p = vertices_[lineIndex * 2];
+	LineVertex q = vertices_[lineIndex * 2 + 1];
+	if (LessVertex(q, p)) {
+		std::swap(p, q);
+	}
+	return p.x == a.x && p.y == a.y && q.x == b.x && q.y == b.y;
+}
+
+void LineBatch::AddLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+	if (deduplicate_) {
+		//線の数が表の半分を超えたら広げる
+		if ((colors_.size() + 1) * 2 > slots_.size()) {
+			GrowTable();
+		}
+		LineVertex a{ x0,y0 };
+		LineVertex b{ x1,y1 };
+		if (LessVertex(b, a)) {
+			std::swap(a, b);
+		}
+		size_t mask = slots_.size() - 1;
+		for (size_t slot = HashLine(a, b, color) & mask;; slot = (slot + 1) & mask) {
+			if (slots_[slot].stamp != stamp_) {
+				slots_[slot] = { stamp_,uint32_t(colors_.size()) };
+				break;
+			}
+			if (IsSameLine(slots_[slot].lineIndex, a, b, color)) {
+				++duplicateCount_;
+				return;
+			}
+		}
+	}
+	vertices_.push_back({ x0,y0 });
+	vertices_.push_back({ x1,y1 });
+	colors_.push_back(color);
+}
+
+void LineBatch::GrowTable() {
+	slots_.assign(slots_.size() * 2, Slot{ 0,0 });
+	stamp_ = 1;
+	//登録済みの線を入れ直す
+	size_t mask = slots_.size() - 1;
+	for (uint32_t lineIndex = 0; lineIndex < uint32_t(colors_.size()); ++lineIndex) {
+		LineVertex a = vertices_[lineIndex * 2];
+		LineVertex b = vertices_[lineIndex * 2 + 1];
+		if (LessVertex(b, a)) {
+			std::swap(a, b);
+		}
+		size_t slot = HashLine(a, b, colors_[lineIndex]) & mask;
+		while (slots_[slot].stamp == stamp_) {
+			slot = (slot + 1) & mask;
+		}
+		slots_[slot] = { stamp_,lineIndex };
+	}
+}
+
+void LineBatch::Flush(ILineSink& sink) {
+	MT2_PROFILE_SCOPE("LineBatch::Flush");
+	if (!colors_.empty()) {
+		sink.Submit(vertices_, colors_);
+	}
+	Clear();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "MathFunction.h"
+
+//スクリーン座標の頂点(整数に変換済み)
+struct LineVertex {
+	int32_t x;
+	int32_t y;
+};
+
+//線の描画先
+//LineBatchは1フレーム分の線をまとめて1回のSubmitで渡す
+class ILineSink {
+public:
+	virtual ~ILineSink() = default;
+	//verticesは2頂点で1本、colorsは線ごとの色
+	virtual void Submit(std::span<const LineVertex> vertices, std::span<const uint32_t> colors) = 0;
+};
+
+//スクリーン座標の線を1本の頂点配列に集める
+//同じ端点と色の線(向きが逆のものも含む)は1本にまとめる
+class LineBatch {
+public:
+	LineBatch();
+
+	void Clear();
+	void AddLine(const Vector3& start, const Vector3& end, uint32_t color);
+	void AddLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+	//集めた線を渡してから空にする
+	void Flush(ILineSink& sink);
+
+	//重複をまとめるかどうか(既定はまとめる)
+	void SetDeduplicate(bool deduplicate) { deduplicate_ = deduplicate; }
+
+	std::span<const LineVertex> GetVertices() const { return vertices_; }
+	std::span<const uint32_t> GetColors() const { return colors_; }
+	size_t GetLineCount() const { return colors_.size(); }
+	//Clearしてからまとめた線の数
+	size_t GetDuplicateCount() const { return duplicateCount_; }
+
+private:
+	//重複判定の表の1要素(stampが今の世代でなければ空き)
+	struct Slot {
+		uint32_t stamp;
+		uint32_t lineIndex;
+	};
+
+	bool IsSameLine(uint32_t lineIndex, const LineVertex& a, const LineVertex& b, uint32_t color) const;
+	void GrowTable();
+
+	std::vector<LineVertex> vertices_;
+	std::vector<uint32_t> colors_;
+	std::vector<Slot> slots_;//大きさは2のべき乗
+	uint32_t stamp_ = 1;
+	size_t duplicateCount_ = 0;
+	bool deduplicate_ = true;
+};
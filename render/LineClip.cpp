@@ -0,0 +1,54 @@
+#include "LineClip.h"
+
+bool ClipLineNear(Vector4& start, Vector4& end) {
+	float dStart = start.z;
+	float dEnd = end.z;
+	if (dStart < 0.0f && dEnd < 0.0f) {
+		return false;
+	}
+	if (dStart >= 0.0f && dEnd >= 0.0f) {
+		return true;
+	}
+	//面との交点まで後ろ側の端点を動かす
+	float t = dStart / (dStart - dEnd);
+	Vector4 point{
+		start.x + (end.x - start.x) * t,
+		start.y + (end.y - start.y) * t,
+		0.0f,
+		start.w + (end.w - start.w) * t,
+	};
+	if (dStart < 0.0f) {
+		start = point;
+	}
+	else {
+		end = point;
+	}
+	return true;
+}
+
+//同じ平面の外側に両端があれば見えない
+static bool IsTriviallyOutside(const Vector4& a, const Vector4& b) {
+	return (a.x < -a.w && b.x < -b.w) || (a.x > a.w && b.x > b.w) ||
+		(a.y < -a.w && b.y < -b.w) || (a.y > a.w && b.y > b.w) ||
+		(a.z < 0.0f && b.z < 0.0f) || (a.z > a.w && b.z > b.w);
+}
+
+bool ProjectClipLine(Vector4 start, Vector4 end, const Matrix4x4& viewportMatrix, Vector3& screenStart, Vector3& screenEnd) {
+	if (IsTriviallyOutside(start, end)) {
+		return false;
+	}
+	if (!ClipLineNear(start, end)) {
+		return false;
+	}
+	//ニアクリップ面より手前ならwはnearClip以上なので0にならない
+	if (start.w <= 0.0f || end.w <= 0.0f) {
+		return false;
+	}
+	screenStart = TransformPoint({ start.x / start.w,start.y / start.w,start.z / start.w }, viewportMatrix);
+	screenEnd = TransformPoint({ end.x / end.w,end.y / end.w,end.z / end.w }, viewportMatrix);
+	return true;
+}
+
+bool ProjectLine(const Vector3& start, const Vector3& end, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, Vector3& screenStart, Vector3& screenEnd) {
+	return ProjectClipLine(TransformHomogeneous(start, viewProjectionMatrix), TransformHomogeneous(end, viewProjectionMatrix), viewportMatrix, screenStart, screenEnd);
+}
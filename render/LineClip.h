@@ -0,0 +1,11 @@
+#pragma once
+#include "MathFunction.h"
+
+//クリップ空間(同次座標)の線分をニアクリップ面(z >= 0)で切り詰める
+//全体が面の後ろならfalse
+bool ClipLineNear(Vector4& start, Vector4& end);
+//クリップ空間の線分をスクリーン座標にする
+//全体が視錐台のどれか1つの面の外側にある場合と、ニアクリップ面の後ろにある場合はfalse
+bool ProjectClipLine(Vector4 start, Vector4 end, const Matrix4x4& viewportMatrix, Vector3& screenStart, Vector3& screenEnd);
+//ワールド座標の線分をスクリーン座標にする(カメラの後ろの部分は切り捨てる)
+bool ProjectLine(const Vector3& start, const Vector3& end, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, Vector3& screenStart, Vector3& screenEnd);
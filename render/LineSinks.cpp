@@ -0,0 +1,91 @@
+#include "LineSinks.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+void CountingLineSink::Submit(std::span<const LineVertex> vertices, std::span<const uint32_t> colors) {
+	(void)vertices;
+	++submitCount_;
+	lineCount_ += colors.size();
+}
+
+void CountingLineSink::Reset() {
+	submitCount_ = 0;
+	lineCount_ = 0;
+}
+
+RasterLineSink::RasterLineSink(uint32_t width, uint32_t height)
+	: width_(width), height_(height), pixels_(size_t(width) * height, 0) {
+}
+
+void RasterLineSink::Clear(uint32_t color) {
+	std::fill(pixels_.begin(), pixels_.end(), color);
+}
+
+void RasterLineSink::Submit(std::span<const LineVertex> vertices, std::span<const uint32_t> colors) {
+	for (size_t lineIndex = 0; lineIndex < colors.size(); ++lineIndex) {
+		DrawLine(vertices[lineIndex * 2], vertices[lineIndex * 2 + 1], colors[lineIndex]);
+	}
+}
+
+//画面の範囲に切り詰めてからブレゼンハムで描く
+void RasterLineSink::DrawLine(LineVertex start, LineVertex end, uint32_t color) {
+	if (width_ == 0 || height_ == 0) {
+		return;
+	}
+	//Liang-Barskyで画面の矩形に切り詰める
+	double x0 = start.x;
+	double y0 = start.y;
+	double dx = double(end.x) - x0;
+	double dy = double(end.y) - y0;
+	double t0 = 0.0;
+	double t1 = 1.0;
+	const double p[4] = { -dx,dx,-dy,dy };
+	const double q[4] = { x0,double(width_ - 1) - x0,y0,double(height_ - 1) - y0 };
+	for (int i = 0; i < 4; ++i) {
+		if (p[i] == 0.0) {
+			if (q[i] < 0.0) {
+				return;
+			}
+			continue;
+		}
+		double t = q[i] / p[i];
+		if (p[i] < 0.0) {
+			t0 = std::max(t0, t);
+		}
+		else {
+			t1 = std::min(t1, t);
+		}
+	}
+	if (t0 > t1) {
+		return;
+	}
+	int32_t x = int32_t(std::lround(x0 + dx * t0));
+	int32_t y = int32_t(std::lround(y0 + dy * t0));
+	int32_t xEnd = int32_t(std::lround(x0 + dx * t1));
+	int32_t yEnd = int32_t(std::lround(y0 + dy * t1));
+
+	int32_t stepX = x < xEnd ? 1 : -1;
+	int32_t stepY = y < yEnd ? 1 : -1;
+	int32_t distanceX = std::abs(xEnd - x);
+	int32_t distanceY = -std::abs(yEnd - y);
+	int32_t error = distanceX + distanceY;
+	while (true) {
+		//丸めで1画素はみ出すことがあるので念のため確かめる
+		if (0 <= x && x < int32_t(width_) && 0 <= y && y < int32_t(height_)) {
+			pixels_[size_t(y) * width_ + size_t(x)] = color;
+		}
+		if (x == xEnd && y == yEnd) {
+			break;
+		}
+		int32_t error2 = error * 2;
+		if (error2 >= distanceY) {
+			error += distanceY;
+			x += stepX;
+		}
+		if (error2 <= distanceX) {
+			error += distanceX;
+			y += stepY;
+		}
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "LineBatch.h"
+
+//受け取った線の数を数えるだけの描画先(ヘッドレスの計測用)
+class CountingLineSink : public ILineSink {
+public:
+	void Submit(std::span<const LineVertex> vertices, std::span<const uint32_t> colors) override;
+
+	uint64_t GetSubmitCount() const { return submitCount_; }
+	uint64_t GetLineCount() const { return lineCount_; }
+	void Reset();
+
+private:
+	uint64_t submitCount_ = 0;
+	uint64_t lineCount_ = 0;
+};
+
+//メモリ上の画像に線を描く描画先(ヘッドレスで描画結果を確かめる用)
+class RasterLineSink : public ILineSink {
+public:
+	RasterLineSink(uint32_t width, uint32_t height);
+
+	void Submit(std::span<const LineVertex> vertices, std::span<const uint32_t> colors) override;
+	void Clear(uint32_t color);
+
+	uint32_t GetWidth() const { return width_; }
+	uint32_t GetHeight() const { return height_; }
+	uint32_t GetPixel(uint32_t x, uint32_t y) const { return pixels_[size_t(y) * width_ + x]; }
+	const std::vector<uint32_t>& GetPixels() const { return pixels_; }
+
+private:
+	void DrawLine(LineVertex start, LineVertex end, uint32_t color);
+
+	uint32_t width_;
+	uint32_t height_;
+	std::vector<uint32_t> pixels_;
+};
@@ -0,0 +1,117 @@
+#include "CollisionLoop.h"
+#include <cstring>
+#include "Frustum.h"
+#include "Profiler.h"
+
+static const uint64_t kFnvPrime = 1099511628211ull;
+
+//バイト列のFNV-1a
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * kFnvPrime;
+	}
+	return hash;
+}
+
+CollisionLoop::CollisionLoop() {
+	camera.translate = { 0.0f,1.9f,-6.49f };
+	camera.rotate = { 0.26f,0.0f,0.0f };
+	camera.fovY = 0.45f;
+	camera.aspectRatio = 1280.0f / 720.0f;
+	camera.nearClip = 0.1f;
+	camera.farClip = 100.0f;
+	camera.viewportWidth = 1280.0f;
+	camera.viewportHeight = 720.0f;
+
+	FrameInput input{};
+	input.cameraTranslate = camera.translate;
+	input.cameraRotate = camera.rotate;
+	input.obb.center = { -1.0f,0.0f,0.0f };
+	input.obb.size = { 0.5f,0.5f,0.5f };
+	input.segment = { { -0.8f,-0.3f,0.0f },{ 0.5f,0.5f,0.5f } };
+	Quaternion rotation = MakeRotateXYZQuaternion(input.rotate);
+	MakeRotateAxes(rotation, input.obb.orientations);
+	Reset(input, rotation);
+}
+
+void CollisionLoop::Reset(const FrameInput& input, const Quaternion& obbRotation) {
+	SetInput(input);
+	obbRotation_ = obbRotation;
+	appliedRotate_ = rotate;
+	appliedSpin_ = spin;
+	spinDelta_ = MakeDeltaRotation(spin, kDeltaTime);
+	previousObbPose_ = { obb.center,obbRotation_ };
+}
+
+FrameInput CollisionLoop::GetInput() const {
+	return { camera.translate,camera.rotate,obb,rotate,spin,segment };
+}
+
+void CollisionLoop::SetInput(const FrameInput& input) {
+	camera.translate = input.cameraTranslate;
+	camera.rotate = input.cameraRotate;
+	obb = input.obb;
+	rotate = input.rotate;
+	spin = input.spin;
+	segment = input.segment;
+}
+
+void CollisionLoop::Update() {
+	//静的な判定と掃引の判定は同じ姿勢を使う
+	OBBPose obbPose{};
+	{
+		MT2_PROFILE_SCOPE("MatrixSetup");
+		//変化が無ければ行列は作り直されない
+		camera.Update();
+
+		if (std::memcmp(&rotate, &appliedRotate_, sizeof(Vector3)) != 0) {
+			obbRotation_ = MakeRotateXYZQuaternion(rotate);
+			appliedRotate_ = rotate;
+		}
+		if (std::memcmp(&spin, &appliedSpin_, sizeof(Vector3)) != 0) {
+			spinDelta_ = MakeDeltaRotation(spin, kDeltaTime);
+			appliedSpin_ = spin;
+		}
+		//回し続けるときは毎フレーム同じ回転を重ねるだけ(三角関数は使わない)
+		if (spin.x != 0.0f || spin.y != 0.0f || spin.z != 0.0f) {
+			obbRotation_ = Normalize(Multiply(spinDelta_, obbRotation_));
+		}
+		//軸は毎フレーム向きから作る(判定はInverseRigidで軸が正規直交であることを前提にしている)
+		obbPose = { obb.center,obbRotation_ };
+		MakeRotateAxes(obbPose.rotation, obb.orientations);
+	}
+
+	{
+		MT2_PROFILE_SCOPE("FrustumCulling");
+		//視錐台はビュープロジェクション行列から毎フレーム取り出す
+		Frustum frustum = MakeFrustum(camera.GetViewProjectionMatrix());
+		isObbVisible_ = IsOBBVisible(frustum, obb);
+	}
+
+	{
+		MT2_PROFILE_SCOPE("Collision");
+		segmentHit_ = {};
+		isHit_ = ObbSegmentIntersect(segment, obb, segmentHit_);
+		//前のフレームから今のフレームまでの動きの途中で当たったか
+		SweptOBB sweptObb{ previousObbPose_,obbPose,obb.size };
+		sweptToi_ = 1.0f;
+		isSweptHit_ = SweptObbSegmentTimeOfImpact(sweptObb, segment, sweptToi_);
+		previousObbPose_ = obbPose;
+		sceneHitIndices_.clear();
+		if (sceneBvh_) {
+			sceneBvh_->QuerySegment(segment, sceneHitIndices_);
+		}
+	}
+}
+
+uint64_t CollisionLoop::HashResult(uint64_t hash) const {
+	const uint8_t flags[3] = { uint8_t(isObbVisible_),uint8_t(isHit_),uint8_t(isSweptHit_) };
+	hash = HashBytes(hash, flags, sizeof(flags));
+	hash = HashBytes(hash, obb.orientations, sizeof(obb.orientations));
+	if (isHit_) {
+		hash = HashBytes(hash, &segmentHit_, sizeof(segmentHit_));
+	}
+	hash = HashBytes(hash, &sweptToi_, sizeof(sweptToi_));
+	return HashBytes(hash, sceneHitIndices_.data(), sceneHitIndices_.size() * sizeof(uint32_t));
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "BVH.h"
+#include "Camera.h"
+#include "Collision.h"
+#include "Quaternion.h"
+#include "SweptCollision.h"
+
+//1フレーム分の入力(WinMainではImGuiで書き換える値)
+struct FrameInput {
+	Vector3 cameraTranslate;
+	Vector3 cameraRotate;
+	OBB obb;//orientationsはUpdateで向きから作り直すので、書き換えても使われない
+	Vector3 rotate;//オイラー角。変えたときだけ向きを作り直す
+	Vector3 spin;//回し続ける速さ(ラジアン/秒)
+	Segment segment;
+};
+
+//WinMainとヘッドレスの再生で共通の更新処理(描画は含まない)
+//入力は公開しているので、ImGuiから直接書き換えてからUpdateを呼ぶ
+class CollisionLoop {
+public:
+	//1フレームの時間(再生しても結果が変わらないように固定)
+	static constexpr float kDeltaTime = 1.0f / 60.0f;
+
+	Camera camera;
+	OBB obb{};
+	Vector3 rotate{};
+	Vector3 spin{};
+	Segment segment{};
+
+	CollisionLoop();
+
+	//入力と向きから状態を作り直す(記録を始めたときの状態から再生するため)
+	void Reset(const FrameInput& input, const Quaternion& obbRotation);
+	FrameInput GetInput() const;
+	void SetInput(const FrameInput& input);
+	//シーンのOBBも線分と判定する(nullptrなら判定しない)
+	void SetScene(const OBBBVH* sceneBvh) { sceneBvh_ = sceneBvh; }
+
+	void Update();
+
+	const Quaternion& GetObbRotation() const { return obbRotation_; }
+	bool IsObbVisible() const { return isObbVisible_; }
+	bool IsHit() const { return isHit_; }
+	const SegmentHit& GetSegmentHit() const { return segmentHit_; }
+	bool IsSweptHit() const { return isSweptHit_; }
+	float GetSweptToi() const { return sweptToi_; }
+	const std::vector<uint32_t>& GetSceneHitIndices() const { return sceneHitIndices_; }
+	//直前のUpdateの結果のハッシュ(最適化の前後で結果が同じか比べる)
+	uint64_t HashResult(uint64_t hash) const;
+
+private:
+	Quaternion obbRotation_{};
+	Vector3 appliedRotate_{};
+	Vector3 appliedSpin_{};
+	Quaternion spinDelta_{};
+	//前のフレームの位置と向き(速く動かして線分をすり抜けていないかを調べる)
+	OBBPose previousObbPose_{};
+	const OBBBVH* sceneBvh_ = nullptr;
+
+	bool isObbVisible_ = false;
+	bool isHit_ = false;
+	SegmentHit segmentHit_{};
+	bool isSweptHit_ = false;
+	float sweptToi_ = 1.0f;
+	std::vector<uint32_t> sceneHitIndices_;
+};
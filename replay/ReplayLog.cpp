@@ -0,0 +1,170 @@
+#include "ReplayLog.h"
+#include <cstdio>
+#include <cstring>
+
+static_assert(sizeof(ReplayHeader) == 36 + sizeof(FrameInput) + sizeof(Quaternion), "ReplayHeader must not contain padding");
+
+//差分を取る欄の数(ビットマスクの桁)
+static const uint32_t kFieldCount = 11;
+
+//入力のVector3の欄を並べる(並び順がビットマスクの桁になる)
+static void GetFields(FrameInput& input, Vector3* fields[kFieldCount]) {
+	fields[0] = &input.cameraTranslate;
+	fields[1] = &input.cameraRotate;
+	fields[2] = &input.obb.center;
+	fields[3] = &input.obb.orientations[0];
+	fields[4] = &input.obb.orientations[1];
+	fields[5] = &input.obb.orientations[2];
+	fields[6] = &input.obb.size;
+	fields[7] = &input.rotate;
+	fields[8] = &input.spin;
+	fields[9] = &input.segment.origin;
+	fields[10] = &input.segment.diff;
+}
+
+const char* GetReplayResultName(ReplayResult result) {
+	switch (result) {
+	case ReplayResult::kOk: return "ok";
+	case ReplayResult::kOpenFailed: return "open failed";
+	case ReplayResult::kWriteFailed: return "write failed";
+	case ReplayResult::kBadMagic: return "bad magic";
+	case ReplayResult::kBadVersion: return "bad version";
+	case ReplayResult::kTruncated: return "truncated";
+	case ReplayResult::kBadData: return "bad data";
+	}
+	return "unknown";
+}
+
+void ReplayRecorder::Begin(const FrameInput& input, const Quaternion& obbRotation, uint64_t sceneChecksum) {
+	isRecording_ = true;
+	header_ = {};
+	header_.magic = kReplayMagic;
+	header_.version = kReplayVersion;
+	header_.checksum = kReplayChecksumSeed;
+	header_.sceneChecksum = sceneChecksum;
+	header_.initialInput = input;
+	header_.initialRotation = obbRotation;
+	data_.clear();
+}
+
+void ReplayRecorder::Record(const FrameInput& before, const FrameInput& after) {
+	FrameInput beforeCopy = before;
+	FrameInput afterCopy = after;
+	Vector3* beforeFields[kFieldCount];
+	Vector3* afterFields[kFieldCount];
+	GetFields(beforeCopy, beforeFields);
+	GetFields(afterCopy, afterFields);
+
+	uint16_t mask = 0;
+	for (uint32_t field = 0; field < kFieldCount; ++field) {
+		//ビット単位で比べる(-0やNaNを書いても再生で同じ値になるように)
+		if (std::memcmp(beforeFields[field], afterFields[field], sizeof(Vector3)) != 0) {
+			mask |= uint16_t(1u << field);
+		}
+	}
+	const uint8_t* maskBytes = reinterpret_cast<const uint8_t*>(&mask);
+	data_.insert(data_.end(), maskBytes, maskBytes + sizeof(mask));
+	for (uint32_t field = 0; field < kFieldCount; ++field) {
+		if (mask & (1u << field)) {
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(afterFields[field]);
+			data_.insert(data_.end(), bytes, bytes + sizeof(Vector3));
+		}
+	}
+	++header_.frameCount;
+}
+
+void ReplayRecorder::RecordResult(const CollisionLoop& loop) {
+	header_.checksum = loop.HashResult(header_.checksum);
+}
+
+ReplayResult ReplayRecorder::End(const char* path) {
+	isRecording_ = false;
+	header_.dataSize = uint32_t(data_.size());
+	FILE* file = std::fopen(path, "wb");
+	if (!file) {
+		return ReplayResult::kOpenFailed;
+	}
+	bool written = std::fwrite(&header_, sizeof(header_), 1, file) == 1 &&
+		(data_.empty() || std::fwrite(data_.data(), data_.size(), 1, file) == 1);
+	written = std::fclose(file) == 0 && written;
+	return written ? ReplayResult::kOk : ReplayResult::kWriteFailed;
+}
+
+ReplayResult ReplayReader::Load(const char* path) {
+	header_ = {};
+	data_.clear();
+	offset_ = 0;
+	FILE* file = std::fopen(path, "rb");
+	if (!file) {
+		return ReplayResult::kOpenFailed;
+	}
+	ReplayResult result = ReplayResult::kOk;
+	if (std::fread(&header_, sizeof(header_), 1, file) != 1) {
+		result = ReplayResult::kTruncated;
+	}
+	else if (header_.magic != kReplayMagic) {
+		result = ReplayResult::kBadMagic;
+	}
+	else if (header_.version != kReplayVersion) {
+		result = ReplayResult::kBadVersion;
+	}
+	else {
+		data_.resize(header_.dataSize);
+		if (!data_.empty() && std::fread(data_.data(), data_.size(), 1, file) != 1) {
+			result = ReplayResult::kTruncated;
+		}
+	}
+	std::fclose(file);
+	if (result != ReplayResult::kOk) {
+		data_.clear();
+		return result;
+	}
+
+	//先に全フレームを辿って、再生中に範囲の外を読まないことを確かめておく
+	size_t offset = 0;
+	for (uint32_t frame = 0; frame < header_.frameCount; ++frame) {
+		uint16_t mask;
+		if (offset + sizeof(mask) > data_.size()) {
+			data_.clear();
+			return ReplayResult::kTruncated;
+		}
+		std::memcpy(&mask, data_.data() + offset, sizeof(mask));
+		offset += sizeof(mask);
+		if ((mask >> kFieldCount) != 0) {
+			data_.clear();
+			return ReplayResult::kBadData;
+		}
+		for (uint32_t field = 0; field < kFieldCount; ++field) {
+			if (mask & (1u << field)) {
+				offset += sizeof(Vector3);
+			}
+		}
+		if (offset > data_.size()) {
+			data_.clear();
+			return ReplayResult::kTruncated;
+		}
+	}
+	if (offset != data_.size()) {
+		data_.clear();
+		return ReplayResult::kBadData;
+	}
+	return ReplayResult::kOk;
+}
+
+bool ReplayReader::Next(FrameInput& input) {
+	if (offset_ >= data_.size()) {
+		return false;
+	}
+	Vector3* fields[kFieldCount];
+	GetFields(input, fields);
+	uint16_t mask;
+	std::memcpy(&mask, data_.data() + offset_, sizeof(mask));
+	offset_ += sizeof(mask);
+	for (uint32_t field = 0; field < kFieldCount; ++field) {
+		if (mask & (1u << field)) {
+			std::memcpy(fields[field], data_.data() + offset_, sizeof(Vector3));
+			offset_ += sizeof(Vector3);
+		}
+	}
+	return true;
+}
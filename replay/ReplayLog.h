@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CollisionLoop.h"
+
+//CollisionLoopの入力の記録(.mt2replay)
+//ヘッダに記録を始めたときの入力と向きを置き、その後にフレームごとの差分を並べる
+//差分は変わったVector3の欄のビットマスク(2バイト)と、変わった欄の値だけを持つ
+//(何も触っていないフレームは2バイト)
+
+const uint32_t kReplayMagic = 0x5232544D;//"MT2R"
+const uint32_t kReplayVersion = 1;
+//結果のハッシュ(FNV-1a)の初期値
+const uint64_t kReplayChecksumSeed = 14695981039346656037ull;
+
+struct ReplayHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t frameCount;
+	uint32_t dataSize;//ヘッダの後ろの差分のバイト数
+	uint64_t checksum;//記録したときの各フレームの結果のハッシュ
+	uint64_t sceneChecksum;//記録したときのシーンファイルのチェックサム(シーンが無ければ0)
+	FrameInput initialInput;
+	Quaternion initialRotation;
+	uint32_t reserved;//8バイト境界に合わせる(0)
+};
+
+enum class ReplayResult {
+	kOk,
+	kOpenFailed,
+	kWriteFailed,
+	kBadMagic,
+	kBadVersion,
+	kTruncated,
+	kBadData,//差分の長さや欄がフレーム数と合わない
+};
+
+const char* GetReplayResultName(ReplayResult result);
+
+//入力を記録する
+class ReplayRecorder {
+public:
+	//記録を始める(入力を書き換える前の状態から始める)
+	void Begin(const FrameInput& input, const Quaternion& obbRotation, uint64_t sceneChecksum);
+	//Updateの前に呼ぶ。beforeは書き換える前、afterは書き換えた後の入力
+	void Record(const FrameInput& before, const FrameInput& after);
+	//Updateの後に呼ぶ
+	void RecordResult(const CollisionLoop& loop);
+	//記録を終えて書き出す
+	ReplayResult End(const char* path);
+
+	bool IsRecording() const { return isRecording_; }
+	uint32_t GetFrameCount() const { return header_.frameCount; }
+	size_t GetDataSize() const { return data_.size(); }
+
+private:
+	bool isRecording_ = false;
+	ReplayHeader header_{};
+	std::vector<uint8_t> data_;
+};
+
+//記録を読んで1フレームずつ入力を戻す
+class ReplayReader {
+public:
+	ReplayResult Load(const char* path);
+	const ReplayHeader& GetHeader() const { return header_; }
+	//最初のフレームに戻る
+	void Rewind() { offset_ = 0; }
+	//次のフレームの差分をinputに重ねる(inputには前のフレームのUpdate後の入力を渡す)。終わりならfalse
+	bool Next(FrameInput& input);
+
+private:
+	ReplayHeader header_{};
+	std::vector<uint8_t> data_;
+	size_t offset_ = 0;
+};
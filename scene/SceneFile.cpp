@@ -0,0 +1,367 @@
+#include "SceneFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "MathFunction.h"
+#include "Profiler.h"
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(SceneFileHeader) == 48 + 8 * kSceneStreamCount, "SceneFileHeader must not contain padding");
+
+static constexpr uint64_t AlignUp(uint64_t value) {
+	return (value + kSceneFileAlignment - 1) / kSceneFileAlignment * kSceneFileAlignment;
+}
+
+//配列の要素数(前半はOBB、後半は線分)
+static uint64_t GetStreamCount(const SceneFileHeader& header, uint32_t stream) {
+	return stream < kSceneStreamOriginX ? header.obbCount : header.segmentCount;
+}
+
+static const uint64_t kFnvOffset = 14695981039346656037ull;
+static const uint64_t kFnvPrime = 1099511628211ull;
+
+//8バイト単位のFNV-1a(sizeは8の倍数)
+static uint64_t HashWords(uint64_t hash, const uint8_t* data, size_t size) {
+	for (size_t offset = 0; offset < size; offset += 8) {
+		uint64_t word;
+		std::memcpy(&word, data + offset, 8);
+		hash = (hash ^ word) * kFnvPrime;
+	}
+	return hash;
+}
+
+const char* GetSceneFileResultName(SceneFileResult result) {
+	switch (result) {
+	case SceneFileResult::kOk: return "ok";
+	case SceneFileResult::kOpenFailed: return "open failed";
+	case SceneFileResult::kMapFailed: return "map failed";
+	case SceneFileResult::kWriteFailed: return "write failed";
+	case SceneFileResult::kBadMagic: return "bad magic";
+	case SceneFileResult::kBadVersion: return "bad version";
+	case SceneFileResult::kBadLayout: return "bad layout";
+	case SceneFileResult::kBadChecksum: return "bad checksum";
+	case SceneFileResult::kBadValue: return "bad value";
+	case SceneFileResult::kParseError: return "parse error";
+	}
+	return "unknown";
+}
+
+MappedSceneFile::~MappedSceneFile() {
+	Close();
+}
+
+//ヘッダと配列の範囲がファイルに収まっているか調べる
+static SceneFileResult CheckLayout(const uint8_t* data, size_t size) {
+	if (size < sizeof(SceneFileHeader)) {
+		return SceneFileResult::kBadLayout;
+	}
+	SceneFileHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	if (header.magic != kSceneFileMagic) {
+		return SceneFileResult::kBadMagic;
+	}
+	if (header.version != kSceneFileVersion) {
+		return SceneFileResult::kBadVersion;
+	}
+	if (header.headerSize != sizeof(SceneFileHeader) || header.streamCount != kSceneStreamCount || header.fileSize != size) {
+		return SceneFileResult::kBadLayout;
+	}
+	//配列は並び順に重ならずに置かれていること
+	uint64_t end = AlignUp(sizeof(SceneFileHeader));
+	for (uint32_t stream = 0; stream < kSceneStreamCount; ++stream) {
+		uint64_t offset = header.streamOffsets[stream];
+		uint64_t count = GetStreamCount(header, stream);
+		if (offset % kSceneFileAlignment != 0 || offset < end || count > (size - offset) / sizeof(float)) {
+			return SceneFileResult::kBadLayout;
+		}
+		end = offset + count * sizeof(float);
+	}
+	if (AlignUp(end) != size) {
+		return SceneFileResult::kBadLayout;
+	}
+	return SceneFileResult::kOk;
+}
+
+SceneFileResult MappedSceneFile::Open(const char* path) {
+	MT2_PROFILE_SCOPE("MappedSceneFile::Open");
+	Close();
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return SceneFileResult::kOpenFailed;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return SceneFileResult::kMapFailed;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!view) {
+		if (mapping) {
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+		return SceneFileResult::kMapFailed;
+	}
+	file_ = file;
+	mapping_ = mapping;
+	data_ = static_cast<const uint8_t*>(view);
+	size_ = size_t(fileSize.QuadPart);
+#else
+	int file = open(path, O_RDONLY);
+	if (file < 0) {
+		return SceneFileResult::kOpenFailed;
+	}
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0) {
+		close(file);
+		return SceneFileResult::kMapFailed;
+	}
+	void* view = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	//割り当てた後はファイルを閉じてもよい
+	close(file);
+	if (view == MAP_FAILED) {
+		return SceneFileResult::kMapFailed;
+	}
+	data_ = static_cast<const uint8_t*>(view);
+	size_ = size_t(status.st_size);
+#endif
+	SceneFileResult result = CheckLayout(data_, size_);
+	if (result != SceneFileResult::kOk) {
+		Close();
+	}
+	return result;
+}
+
+void MappedSceneFile::Close() {
+	if (!data_) {
+		return;
+	}
+#if defined(_WIN32)
+	UnmapViewOfFile(data_);
+	CloseHandle(mapping_);
+	CloseHandle(file_);
+	file_ = nullptr;
+	mapping_ = nullptr;
+#else
+	munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+	data_ = nullptr;
+	size_ = 0;
+}
+
+const float* MappedSceneFile::GetStream(SceneStream stream) const {
+	//配列は64バイト境界にあるのでfloatとして直接読める
+	return reinterpret_cast<const float*>(data_ + GetHeader().streamOffsets[stream]);
+}
+
+OBBSoAView MappedSceneFile::GetOBBs() const {
+	OBBSoAView view{};
+	if (!data_) {
+		return view;
+	}
+	view.centerX = GetStream(kSceneStreamCenterX);
+	view.centerY = GetStream(kSceneStreamCenterY);
+	view.centerZ = GetStream(kSceneStreamCenterZ);
+	for (int axis = 0; axis < 3; ++axis) {
+		for (int component = 0; component < 3; ++component) {
+			view.orientations[axis][component] = GetStream(SceneStream(kSceneStreamOrientation + axis * 3 + component));
+		}
+	}
+	view.sizeX = GetStream(kSceneStreamSizeX);
+	view.sizeY = GetStream(kSceneStreamSizeY);
+	view.sizeZ = GetStream(kSceneStreamSizeZ);
+	view.count = size_t(GetHeader().obbCount);
+	return view;
+}
+
+SegmentSoAView MappedSceneFile::GetSegments() const {
+	if (!data_) {
+		return {};
+	}
+	return { GetStream(kSceneStreamOriginX),GetStream(kSceneStreamOriginY),GetStream(kSceneStreamOriginZ),
+		GetStream(kSceneStreamDiffX),GetStream(kSceneStreamDiffY),GetStream(kSceneStreamDiffZ),size_t(GetHeader().segmentCount) };
+}
+
+SceneFileResult WriteSceneFile(const char* path, const OBBSoAView& obbs, const SegmentSoAView& segments) {
+	MT2_PROFILE_SCOPE("WriteSceneFile");
+	const float* streams[kSceneStreamCount] = {
+		obbs.centerX,obbs.centerY,obbs.centerZ,
+		obbs.orientations[0][0],obbs.orientations[0][1],obbs.orientations[0][2],
+		obbs.orientations[1][0],obbs.orientations[1][1],obbs.orientations[1][2],
+		obbs.orientations[2][0],obbs.orientations[2][1],obbs.orientations[2][2],
+		obbs.sizeX,obbs.sizeY,obbs.sizeZ,
+		segments.originX,segments.originY,segments.originZ,
+		segments.diffX,segments.diffY,segments.diffZ,
+	};
+
+	SceneFileHeader header{};
+	header.magic = kSceneFileMagic;
+	header.version = kSceneFileVersion;
+	header.headerSize = sizeof(SceneFileHeader);
+	header.streamCount = kSceneStreamCount;
+	header.obbCount = obbs.count;
+	header.segmentCount = segments.count;
+	uint64_t offset = AlignUp(sizeof(SceneFileHeader));
+	for (uint32_t stream = 0; stream < kSceneStreamCount; ++stream) {
+		header.streamOffsets[stream] = offset;
+		offset = AlignUp(offset + GetStreamCount(header, stream) * sizeof(float));
+	}
+	header.fileSize = offset;
+
+	FILE* file = std::fopen(path, "wb");
+	if (!file) {
+		return SceneFileResult::kOpenFailed;
+	}
+	//ヘッダはチェックサムが決まってから書き直す
+	bool isWritten = std::fseek(file, long(header.streamOffsets[0]), SEEK_SET) == 0;
+
+	//配列は64バイト単位の塊に区切って書く(最後の塊の余りは0で埋める)
+	const size_t kChunkFloats = 16384;
+	std::vector<float> chunk(kChunkFloats);
+	uint64_t hash = kFnvOffset;
+	for (uint32_t stream = 0; stream < kSceneStreamCount && isWritten; ++stream) {
+		size_t count = size_t(GetStreamCount(header, stream));
+		for (size_t begin = 0; begin < count && isWritten; begin += kChunkFloats) {
+			size_t chunkCount = std::min(kChunkFloats, count - begin);
+			std::memcpy(chunk.data(), streams[stream] + begin, chunkCount * sizeof(float));
+			size_t chunkBytes = size_t(AlignUp(chunkCount * sizeof(float)));
+			std::memset(reinterpret_cast<uint8_t*>(chunk.data()) + chunkCount * sizeof(float), 0, chunkBytes - chunkCount * sizeof(float));
+			hash = HashWords(hash, reinterpret_cast<const uint8_t*>(chunk.data()), chunkBytes);
+			isWritten = std::fwrite(chunk.data(), 1, chunkBytes, file) == chunkBytes;
+		}
+	}
+	header.checksum = hash;
+
+	//ヘッダの後ろの余白も0で埋める
+	uint8_t headerBytes[AlignUp(sizeof(SceneFileHeader))] = {};
+	std::memcpy(headerBytes, &header, sizeof(header));
+	isWritten = isWritten && std::fseek(file, 0, SEEK_SET) == 0 &&
+		std::fwrite(headerBytes, 1, sizeof(headerBytes), file) == sizeof(headerBytes);
+	if (std::fclose(file) != 0) {
+		isWritten = false;
+	}
+	return isWritten ? SceneFileResult::kOk : SceneFileResult::kWriteFailed;
+}
+
+SceneFileResult ValidateSceneFile(const MappedSceneFile& scene, size_t& badIndex) {
+	MT2_PROFILE_SCOPE("ValidateSceneFile");
+	badIndex = 0;
+	if (!scene.IsOpen()) {
+		return SceneFileResult::kOpenFailed;
+	}
+	const SceneFileHeader& header = scene.GetHeader();
+	size_t dataOffset = size_t(header.streamOffsets[0]);
+	if (HashWords(kFnvOffset, scene.GetData() + dataOffset, scene.GetSize() - dataOffset) != header.checksum) {
+		return SceneFileResult::kBadChecksum;
+	}
+
+	//軸は正規直交とみなして使うので、ずれが大きいものは弾く
+	const float kOrthonormalTolerance = 1.0e-3f;
+	OBBSoAView obbs = scene.GetOBBs();
+	for (size_t i = 0; i < obbs.count; ++i) {
+		Vector3 axes[3];
+		bool isValid = std::isfinite(obbs.centerX[i]) && std::isfinite(obbs.centerY[i]) && std::isfinite(obbs.centerZ[i]) &&
+			obbs.sizeX[i] >= 0.0f && obbs.sizeY[i] >= 0.0f && obbs.sizeZ[i] >= 0.0f &&
+			std::isfinite(obbs.sizeX[i]) && std::isfinite(obbs.sizeY[i]) && std::isfinite(obbs.sizeZ[i]);
+		for (int axis = 0; axis < 3; ++axis) {
+			axes[axis] = { obbs.orientations[axis][0][i],obbs.orientations[axis][1][i],obbs.orientations[axis][2][i] };
+			isValid = isValid && std::isfinite(axes[axis].x) && std::isfinite(axes[axis].y) && std::isfinite(axes[axis].z) &&
+				std::fabs(Dot(axes[axis], axes[axis]) - 1.0f) <= kOrthonormalTolerance;
+		}
+		isValid = isValid && std::fabs(Dot(axes[0], axes[1])) <= kOrthonormalTolerance &&
+			std::fabs(Dot(axes[1], axes[2])) <= kOrthonormalTolerance && std::fabs(Dot(axes[2], axes[0])) <= kOrthonormalTolerance;
+		if (!isValid) {
+			badIndex = i;
+			return SceneFileResult::kBadValue;
+		}
+	}
+	SegmentSoAView segments = scene.GetSegments();
+	for (size_t i = 0; i < segments.count; ++i) {
+		if (!std::isfinite(segments.originX[i]) || !std::isfinite(segments.originY[i]) || !std::isfinite(segments.originZ[i]) ||
+			!std::isfinite(segments.diffX[i]) || !std::isfinite(segments.diffY[i]) || !std::isfinite(segments.diffZ[i])) {
+			badIndex = obbs.count + i;
+			return SceneFileResult::kBadValue;
+		}
+	}
+	return SceneFileResult::kOk;
+}
+
+//空白区切りの数値をcount個読む
+static bool ParseFloats(const char*& cursor, float* values, int count) {
+	for (int i = 0; i < count; ++i) {
+		char* end = nullptr;
+		values[i] = std::strtof(cursor, &end);
+		if (end == cursor) {
+			return false;
+		}
+		cursor = end;
+	}
+	return true;
+}
+
+static bool IsLineEnd(const char* cursor) {
+	while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n') {
+		++cursor;
+	}
+	return *cursor == '\0';
+}
+
+SceneFileResult LoadSceneText(const char* path, OBBSoA& obbs, SegmentSoA& segments, size_t& errorLine) {
+	MT2_PROFILE_SCOPE("LoadSceneText");
+	errorLine = 0;
+	FILE* file = std::fopen(path, "r");
+	if (!file) {
+		return SceneFileResult::kOpenFailed;
+	}
+	char line[512];
+	size_t lineNumber = 0;
+	SceneFileResult result = SceneFileResult::kOk;
+	while (std::fgets(line, sizeof(line), file)) {
+		++lineNumber;
+		if (char* comment = std::strchr(line, '#')) {
+			*comment = '\0';
+		}
+		const char* cursor = line;
+		while (*cursor == ' ' || *cursor == '\t') {
+			++cursor;
+		}
+		float values[9];
+		if (IsLineEnd(cursor)) {
+			continue;
+		}
+		else if (std::strncmp(cursor, "obb ", 4) == 0 && ParseFloats(cursor += 4, values, 9) && IsLineEnd(cursor)) {
+			Matrix4x4 rotateMatrix = MakeRotateXYZMatrix({ values[3],values[4],values[5] });
+			OBB obb{};
+			obb.center = { values[0],values[1],values[2] };
+			for (int axis = 0; axis < 3; ++axis) {
+				obb.orientations[axis] = { rotateMatrix.m[axis][0],rotateMatrix.m[axis][1],rotateMatrix.m[axis][2] };
+			}
+			obb.size = { values[6],values[7],values[8] };
+			obbs.PushBack(obb);
+		}
+		else if (std::strncmp(cursor, "segment ", 8) == 0 && ParseFloats(cursor += 8, values, 6) && IsLineEnd(cursor)) {
+			segments.PushBack({ { values[0],values[1],values[2] },{ values[3],values[4],values[5] } });
+		}
+		else {
+			errorLine = lineNumber;
+			result = SceneFileResult::kParseError;
+			break;
+		}
+	}
+	std::fclose(file);
+	return result;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Collision.h"
+
+//シーンファイル(.mt2scene)
+//ヘッダの後ろにOBBSoA・SegmentSoAと同じ並びのfloat配列を64バイト境界で並べる
+//リトルエンディアンのみ。mmapしたまま各配列をSoAViewとして参照できる
+
+//配列の並び(ヘッダのstreamOffsetsの添字)
+enum SceneStream : uint32_t {
+	kSceneStreamCenterX,
+	kSceneStreamCenterY,
+	kSceneStreamCenterZ,
+	kSceneStreamOrientation,//[軸][成分]の順に9本
+	kSceneStreamSizeX = kSceneStreamOrientation + 9,
+	kSceneStreamSizeY,
+	kSceneStreamSizeZ,
+	kSceneStreamOriginX,
+	kSceneStreamOriginY,
+	kSceneStreamOriginZ,
+	kSceneStreamDiffX,
+	kSceneStreamDiffY,
+	kSceneStreamDiffZ,
+	kSceneStreamCount,
+};
+
+const uint32_t kSceneFileMagic = 0x5332544D;//ファイル先頭の4バイトが"MT2S"になる(ビッグエンディアンでは一致しない)
+const uint32_t kSceneFileVersion = 1;
+const size_t kSceneFileAlignment = 64;
+
+struct SceneFileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t headerSize;//sizeof(SceneFileHeader)
+	uint32_t streamCount;//kSceneStreamCount
+	uint64_t obbCount;
+	uint64_t segmentCount;
+	uint64_t fileSize;
+	uint64_t checksum;//最初の配列からファイル末尾までの8バイトごとのFNV-1a
+	uint64_t streamOffsets[kSceneStreamCount];//ファイル先頭からのバイト数
+};
+
+enum class SceneFileResult {
+	kOk,
+	kOpenFailed,
+	kMapFailed,
+	kWriteFailed,
+	kBadMagic,
+	kBadVersion,
+	kBadLayout,
+	kBadChecksum,
+	kBadValue,
+	kParseError,
+};
+
+const char* GetSceneFileResultName(SceneFileResult result);
+
+//シーンファイルを読み取り専用でメモリに割り当てる
+//Openではヘッダと配列の範囲だけを調べるので、要素数によらずすぐに終わる
+//中身(チェックサムや値)は調べないので、判定に使う前にValidateSceneFileを呼ぶこと
+class MappedSceneFile {
+public:
+	MappedSceneFile() = default;
+	~MappedSceneFile();
+	MappedSceneFile(const MappedSceneFile&) = delete;
+	MappedSceneFile& operator=(const MappedSceneFile&) = delete;
+
+	SceneFileResult Open(const char* path);
+	void Close();
+
+	bool IsOpen() const { return data_ != nullptr; }
+	const SceneFileHeader& GetHeader() const { return *reinterpret_cast<const SceneFileHeader*>(data_); }
+	const uint8_t* GetData() const { return data_; }
+	size_t GetSize() const { return size_; }
+	//ファイルの中を直接指す(Closeすると無効になる)
+	OBBSoAView GetOBBs() const;
+	SegmentSoAView GetSegments() const;
+
+private:
+	const float* GetStream(SceneStream stream) const;
+
+	const uint8_t* data_ = nullptr;
+	size_t size_ = 0;
+#if defined(_WIN32)
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#endif
+};
+
+//SoAをそのままシーンファイルに書き出す
+SceneFileResult WriteSceneFile(const char* path, const OBBSoAView& obbs, const SegmentSoAView& segments);
+
+//全要素を調べる(チェックサム、有限の値か、サイズが負でないか、軸が正規直交か)
+//値が不正な場合はbadIndexにOBB(線分ならOBBの数+線分の番号)の番号を入れる
+SceneFileResult ValidateSceneFile(const MappedSceneFile& scene, size_t& badIndex);
+
+//テキストのシーンを読む。1行に1つ、#から行末はコメント
+//  obb cx cy cz rx ry rz sx sy sz   (回転はMakeRotateXYZMatrixと同じX→Y→Zのラジアン)
+//  segment ox oy oz dx dy dz
+//読めなかった場合はerrorLineに1から数えた行番号を入れる
+SceneFileResult LoadSceneText(const char* path, OBBSoA& obbs, SegmentSoA& segments, size_t& errorLine);
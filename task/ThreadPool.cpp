@@ -0,0 +1,158 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+
+ThreadPool::ThreadPool(uint32_t workerCount) : ownerThread_(std::this_thread::get_id()) {
+	if (workerCount == 0) {
+		workerCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	queues_.resize(workerCount);
+	for (auto& queue : queues_) {
+		queue = std::make_unique<WorkerQueue>();
+	}
+	//ワーカー0は呼び出し側のスレッドなので作らない
+	threads_.reserve(workerCount - 1);
+	for (uint32_t i = 1; i < workerCount; ++i) {
+		threads_.emplace_back([this, i]() { WorkerLoop(i); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		stop_ = true;
+	}
+	condition_.notify_all();
+	for (auto& thread : threads_) {
+		thread.join();
+	}
+}
+
+void ThreadPool::Submit(uint32_t workerIndex, Task task) {
+	Push(workerIndex, std::move(task));
+	Notify(1);
+}
+
+void ThreadPool::Wait() {
+	//ワーカーのスレッドから待つと、実行中の自分のタスクが終わらないので戻れない
+	assert(std::this_thread::get_id() == ownerThread_);
+	while (pendingCount_.load(std::memory_order_acquire) > 0) {
+		if (TryRunTask(0)) {
+			continue;
+		}
+		//他のワーカーが実行中のタスクが終わるか、新しいタスクが積まれるまで寝る
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		condition_.wait(lock, [this]() {
+			return pendingCount_.load(std::memory_order_acquire) == 0 || queuedCount_.load(std::memory_order_acquire) > 0;
+			});
+	}
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t chunkSize, const RangeTask& task) {
+	assert(std::this_thread::get_id() == ownerThread_);
+	if (count == 0) {
+		return;
+	}
+	chunkSize = std::max<size_t>(chunkSize, 1);
+	size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+	size_t workerCount = queues_.size();
+
+	//1スレッドか1チャンクならそのまま実行する
+	if (workerCount == 1 || chunkCount == 1) {
+		for (size_t begin = 0; begin < count; begin += chunkSize) {
+			task(begin, std::min(begin + chunkSize, count), 0);
+		}
+		return;
+	}
+
+	//ワーカーごとに連続したチャンクを積む(自分のキューは後ろから取るので逆順に積む)
+	for (size_t worker = 0; worker < workerCount; ++worker) {
+		size_t firstChunk = chunkCount * worker / workerCount;
+		size_t lastChunk = chunkCount * (worker + 1) / workerCount;
+		for (size_t chunk = lastChunk; chunk > firstChunk; --chunk) {
+			size_t begin = (chunk - 1) * chunkSize;
+			size_t end = std::min(begin + chunkSize, count);
+			Push(uint32_t(worker), [&task, begin, end](uint32_t workerIndex) { task(begin, end, workerIndex); });
+		}
+	}
+	Notify(chunkCount);
+	Wait();
+}
+
+void ThreadPool::WorkerLoop(uint32_t workerIndex) {
+	while (true) {
+		if (TryRunTask(workerIndex)) {
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		condition_.wait(lock, [this]() { return stop_ || queuedCount_.load(std::memory_order_acquire) > 0; });
+		if (stop_) {
+			return;
+		}
+	}
+}
+
+bool ThreadPool::TryRunTask(uint32_t workerIndex) {
+	Task task;
+	bool found = false;
+
+	//自分のキューの後ろから取る
+	{
+		WorkerQueue& queue = *queues_[workerIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			found = true;
+		}
+	}
+	//空なら隣から順に他のキューの前から盗む
+	for (size_t offset = 1; !found && offset < queues_.size(); ++offset) {
+		WorkerQueue& victim = *queues_[(workerIndex + offset) % queues_.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			found = true;
+			stealCount_.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	if (!found) {
+		return false;
+	}
+
+	queuedCount_.fetch_sub(1, std::memory_order_acq_rel);
+	task(workerIndex);
+	if (pendingCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		//最後のタスクが終わったらWaitしているスレッドを起こす
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex_);
+		}
+		condition_.notify_all();
+	}
+	return true;
+}
+
+void ThreadPool::Push(uint32_t workerIndex, Task task) {
+	assert(workerIndex < queues_.size());
+	//先に数を増やしておき、取り出し側で負にならないようにする
+	pendingCount_.fetch_add(1, std::memory_order_acq_rel);
+	queuedCount_.fetch_add(1, std::memory_order_acq_rel);
+	WorkerQueue& queue = *queues_[workerIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	queue.tasks.push_back(std::move(task));
+}
+
+void ThreadPool::Notify(size_t pushedCount) {
+	//寝る判定とのすれ違いを防ぐため、sleepMutex_を通してから起こす
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+	}
+	if (pushedCount == 1) {
+		condition_.notify_one();
+	}
+	else {
+		condition_.notify_all();
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//ワーカーごとにタスクの両端キューを持つスレッドプール
+//自分のキューは後ろから取り、空になったら他のワーカーのキューの前から盗む
+//呼び出し側のスレッドもワーカー0としてWait中にタスクを処理する
+//WaitとParallelForはプールを作ったスレッドからだけ呼ぶこと
+//(タスクの中から呼ぶと、終わっていないタスクに自分自身が数えられて戻ってこない)
+class ThreadPool {
+public:
+	//引数はワーカーの数(呼び出し側のスレッドを含む)。0ならハードウェアのスレッド数
+	explicit ThreadPool(uint32_t workerCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//引数は実行しているワーカーの番号
+	using Task = std::function<void(uint32_t workerIndex)>;
+	//[begin,end)の範囲を処理する
+	using RangeTask = std::function<void(size_t begin, size_t end, uint32_t workerIndex)>;
+
+	//指定したワーカーのキューに積む
+	void Submit(uint32_t workerIndex, Task task);
+	//積んだタスクが全て終わるまで待つ(待つ間は呼び出し側もタスクを処理する。作ったスレッドからだけ呼べる)
+	void Wait();
+	//[0,count)をchunkSizeごとのタスクに分けて処理し、全て終わるまで待つ(作ったスレッドからだけ呼べる。入れ子にはできない)
+	//チャンクは番号順に連続した塊でワーカーに配り、偏った分は盗み合いで均す
+	void ParallelFor(size_t count, size_t chunkSize, const RangeTask& task);
+
+	uint32_t GetWorkerCount() const { return uint32_t(queues_.size()); }
+	//他のワーカーから盗んだタスクの累計
+	uint64_t GetStealCount() const { return stealCount_.load(std::memory_order_relaxed); }
+
+private:
+	struct WorkerQueue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void WorkerLoop(uint32_t workerIndex);
+	bool TryRunTask(uint32_t workerIndex);
+	void Push(uint32_t workerIndex, Task task);
+	void Notify(size_t pushedCount);
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues_;
+	std::vector<std::thread> threads_;
+	std::thread::id ownerThread_;//プールを作ったスレッド(ワーカー0)
+	std::mutex sleepMutex_;
+	std::condition_variable condition_;
+	std::atomic<size_t> queuedCount_{ 0 };//キューに入っているタスク数
+	std::atomic<size_t> pendingCount_{ 0 };//まだ終わっていないタスク数
+	std::atomic<uint64_t> stealCount_{ 0 };
+	bool stop_ = false;
+};
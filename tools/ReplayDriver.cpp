@@ -0,0 +1,246 @@
+//衝突判定のループを画面なしで回す
+//使い方: MT2Replay --generate=FRAMES [--seed=N] [--scene=path] <output.mt2replay>
+//        MT2Replay [--scene=path] [--repeat=N] [--trace=path] <input.mt2replay>
+//記録はWinMainのImGuiの"Record replay"か--generateで作る
+//再生は待たずに全フレームを回し、1フレームの時間の分布と結果のハッシュを出す
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "BVH.h"
+#include "CollisionLoop.h"
+#include "Profiler.h"
+#include "ReplayLog.h"
+#include "SceneFile.h"
+
+namespace {
+
+struct DriverConfig {
+	uint32_t generateFrames = 0;//0なら再生する
+	uint32_t seed = 12345;
+	uint32_t repeat = 1;
+	const char* scenePath = nullptr;
+	const char* tracePath = nullptr;
+	const char* replayPath = nullptr;
+};
+
+bool ParseArguments(int argc, char** argv, DriverConfig& config) {
+	for (int i = 1; i < argc; ++i) {
+		const char* argument = argv[i];
+		if (std::strncmp(argument, "--generate=", 11) == 0) {
+			config.generateFrames = uint32_t(std::strtoul(argument + 11, nullptr, 10));
+			if (config.generateFrames == 0) {
+				return false;
+			}
+		}
+		else if (std::strncmp(argument, "--seed=", 7) == 0) {
+			config.seed = uint32_t(std::strtoul(argument + 7, nullptr, 10));
+		}
+		else if (std::strncmp(argument, "--repeat=", 9) == 0) {
+			config.repeat = std::max<uint32_t>(uint32_t(std::strtoul(argument + 9, nullptr, 10)), 1);
+		}
+		else if (std::strncmp(argument, "--scene=", 8) == 0) {
+			config.scenePath = argument + 8;
+		}
+		else if (std::strncmp(argument, "--trace=", 8) == 0) {
+			config.tracePath = argument + 8;
+		}
+		else if (argument[0] != '-' && !config.replayPath) {
+			config.replayPath = argument;
+		}
+		else {
+			return false;
+		}
+	}
+	return config.replayPath != nullptr;
+}
+
+//シーンを割り当てて全要素を検査し、BVHを作る(パスが無ければ何もしない)
+bool OpenScene(const char* path, MappedSceneFile& scene, OBBBVH& bvh, CollisionLoop& loop) {
+	if (!path) {
+		return true;
+	}
+	SceneFileResult result = scene.Open(path);
+	if (result != SceneFileResult::kOk) {
+		std::fprintf(stderr, "%s: %s\n", path, GetSceneFileResultName(result));
+		return false;
+	}
+	size_t badIndex = 0;
+	result = ValidateSceneFile(scene, badIndex);
+	if (result == SceneFileResult::kBadValue) {
+		std::fprintf(stderr, "%s: %s (element %zu)\n", path, GetSceneFileResultName(result), badIndex);
+		return false;
+	}
+	else if (result != SceneFileResult::kOk) {
+		std::fprintf(stderr, "%s: %s\n", path, GetSceneFileResultName(result));
+		return false;
+	}
+	bvh.Build(scene.GetOBBs());
+	loop.SetScene(&bvh);
+	return true;
+}
+
+//ImGuiを触る人の代わりに入力を動かす
+//ほとんどのフレームは何も触らず、ときどき数十フレーム続けて1つの値をドラッグする
+class InputScript {
+public:
+	explicit InputScript(uint32_t seed) : engine_(seed) {}
+
+	void Apply(FrameInput& input) {
+		if (dragFrames_ == 0) {
+			std::uniform_int_distribution<uint32_t> idle(0, 3);
+			//4回に1回は次のドラッグを始める
+			if (idle(engine_) != 0) {
+				return;
+			}
+			std::uniform_int_distribution<uint32_t> target(0, kTargetCount - 1);
+			std::uniform_int_distribution<uint32_t> frames(10, 90);
+			std::uniform_real_distribution<float> speed(-0.03f, 0.03f);
+			target_ = target(engine_);
+			dragFrames_ = frames(engine_);
+			velocity_ = { speed(engine_),speed(engine_),speed(engine_) };
+		}
+		--dragFrames_;
+		Vector3* targets[kTargetCount] = { &input.cameraTranslate,&input.cameraRotate,&input.obb.center,&input.rotate,&input.spin,
+			&input.segment.origin,&input.segment.diff };
+		Vector3& value = *targets[target_];
+		value = Add(value, target_ == 4 ? Multiply(10.0f, velocity_) : velocity_);
+		//回転の速さは大きくなりすぎないように止める
+		if (target_ == 4 && Length(value) > 8.0f) {
+			value = { 0.0f,0.0f,0.0f };
+		}
+	}
+
+private:
+	static const uint32_t kTargetCount = 7;
+	std::mt19937 engine_;
+	uint32_t target_ = 0;
+	uint32_t dragFrames_ = 0;
+	Vector3 velocity_{};
+};
+
+int Generate(const DriverConfig& config) {
+	CollisionLoop loop;
+	MappedSceneFile scene;
+	OBBBVH sceneBvh;
+	if (!OpenScene(config.scenePath, scene, sceneBvh, loop)) {
+		return 1;
+	}
+	ReplayRecorder recorder;
+	recorder.Begin(loop.GetInput(), loop.GetObbRotation(), scene.IsOpen() ? scene.GetHeader().checksum : 0);
+	InputScript script(config.seed);
+	for (uint32_t frame = 0; frame < config.generateFrames; ++frame) {
+		FrameInput before = loop.GetInput();
+		FrameInput input = before;
+		script.Apply(input);
+		recorder.Record(before, input);
+		loop.SetInput(input);
+		loop.Update();
+		recorder.RecordResult(loop);
+	}
+	size_t dataSize = recorder.GetDataSize();
+	ReplayResult result = recorder.End(config.replayPath);
+	if (result != ReplayResult::kOk) {
+		std::fprintf(stderr, "%s: %s\n", config.replayPath, GetReplayResultName(result));
+		return 1;
+	}
+	std::printf("%s: %u frames, %zu bytes of input (%.1f bytes/frame)\n", config.replayPath, config.generateFrames,
+		dataSize, double(dataSize) / double(config.generateFrames));
+	return 0;
+}
+
+int Play(const DriverConfig& config) {
+	ReplayReader reader;
+	ReplayResult result = reader.Load(config.replayPath);
+	if (result != ReplayResult::kOk) {
+		std::fprintf(stderr, "%s: %s\n", config.replayPath, GetReplayResultName(result));
+		return 1;
+	}
+	const ReplayHeader& header = reader.GetHeader();
+	CollisionLoop loop;
+	MappedSceneFile scene;
+	OBBBVH sceneBvh;
+	if (!OpenScene(config.scenePath, scene, sceneBvh, loop)) {
+		return 1;
+	}
+	//記録したときと別のシーンでは結果が変わるので、ハッシュは比べない
+	uint64_t sceneChecksum = scene.IsOpen() ? scene.GetHeader().checksum : 0;
+	bool compareChecksum = sceneChecksum == header.sceneChecksum;
+	if (!compareChecksum) {
+		std::fprintf(stderr, "%s: recorded with a different scene, checksum is not compared\n", config.replayPath);
+	}
+
+	Profiler& profiler = Profiler::Get();
+	if (config.tracePath) {
+		profiler.SetFrameCapacity(std::max<size_t>(header.frameCount, 1));
+	}
+	std::vector<double> frameNs;
+	frameNs.reserve(size_t(header.frameCount) * config.repeat);
+	uint64_t checksum = kReplayChecksumSeed;
+	bool isMatched = true;
+	for (uint32_t pass = 0; pass < config.repeat; ++pass) {
+		//トレースは最初の1回だけ取る
+		const bool isTracing = config.tracePath && pass == 0;
+		loop.Reset(header.initialInput, header.initialRotation);
+		reader.Rewind();
+		checksum = kReplayChecksumSeed;
+		FrameInput input = loop.GetInput();
+		while (reader.Next(input)) {
+			auto start = std::chrono::steady_clock::now();
+			if (isTracing) {
+				profiler.BeginFrame();
+			}
+			loop.SetInput(input);
+			loop.Update();
+			if (isTracing) {
+				profiler.EndFrame();
+			}
+			frameNs.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+			checksum = loop.HashResult(checksum);
+			input = loop.GetInput();
+		}
+		isMatched = isMatched && checksum == header.checksum;
+	}
+	if (config.tracePath && !profiler.WriteChromeTrace(config.tracePath)) {
+		std::fprintf(stderr, "cannot open %s\n", config.tracePath);
+		return 1;
+	}
+	if (frameNs.empty()) {
+		std::printf("%s: no frames\n", config.replayPath);
+		return 0;
+	}
+
+	double totalNs = 0.0;
+	for (double ns : frameNs) {
+		totalNs += ns;
+	}
+	std::vector<double> sorted = frameNs;
+	std::sort(sorted.begin(), sorted.end());
+	auto percentile = [&](double p) {
+		return sorted[std::min(sorted.size() - 1, size_t(p * double(sorted.size())))];
+	};
+	std::printf("%s: %u frames x %u passes\n", config.replayPath, header.frameCount, config.repeat);
+	std::printf("total %.3f ms, %.0f frames/sec\n", totalNs * 1.0e-6, double(frameNs.size()) / (totalNs * 1.0e-9));
+	std::printf("frame p50 %.2f us, p99 %.2f us, max %.2f us\n", percentile(0.50) * 1.0e-3, percentile(0.99) * 1.0e-3,
+		sorted.back() * 1.0e-3);
+	std::printf("checksum %016llx (recorded %016llx) %s\n", (unsigned long long)checksum, (unsigned long long)header.checksum,
+		!compareChecksum ? "not compared" : isMatched ? "match" : "MISMATCH");
+	return compareChecksum && !isMatched ? 1 : 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+	DriverConfig config;
+	if (!ParseArguments(argc, argv, config)) {
+		std::fprintf(stderr,
+			"usage: MT2Replay --generate=FRAMES [--seed=N] [--scene=path] <output.mt2replay>\n"
+			"       MT2Replay [--scene=path] [--repeat=N] [--trace=path] <input.mt2replay>\n");
+		return 1;
+	}
+	return config.generateFrames != 0 ? Generate(config) : Play(config);
+}
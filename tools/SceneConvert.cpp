@@ -0,0 +1,126 @@
+//テキストのシーンをシーンファイル(.mt2scene)に変換して検査する
+//使い方: MT2SceneConvert <input.txt> <output.mt2scene>
+//        MT2SceneConvert --random=OBBS,SEGMENTS [--seed=N] <output.mt2scene>
+//        MT2SceneConvert --validate <scene.mt2scene>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include "Collision.h"
+#include "MathFunction.h"
+#include "SceneFile.h"
+
+namespace {
+
+//大きなシーンを試すための乱数のシーン(OBBはcount個を立方体の中にばらまく)
+void MakeRandomScene(size_t obbCount, size_t segmentCount, uint32_t seed, OBBSoA& obbs, SegmentSoA& segments) {
+	std::mt19937 engine(seed);
+	//体積あたりの数が変わらないように広げる
+	float range = 4.0f * std::cbrt(float(obbCount) + 1.0f);
+	std::uniform_real_distribution<float> position(-range, range);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> size(0.1f, 1.0f);
+	std::uniform_real_distribution<float> diff(-8.0f, 8.0f);
+	for (size_t i = 0; i < obbCount; ++i) {
+		Matrix4x4 rotateMatrix = MakeRotateXYZMatrix({ angle(engine),angle(engine),angle(engine) });
+		OBB obb{};
+		obb.center = { position(engine),position(engine),position(engine) };
+		for (int axis = 0; axis < 3; ++axis) {
+			obb.orientations[axis] = { rotateMatrix.m[axis][0],rotateMatrix.m[axis][1],rotateMatrix.m[axis][2] };
+		}
+		obb.size = { size(engine),size(engine),size(engine) };
+		obbs.PushBack(obb);
+	}
+	for (size_t i = 0; i < segmentCount; ++i) {
+		segments.PushBack({ { position(engine),position(engine),position(engine) },{ diff(engine),diff(engine),diff(engine) } });
+	}
+}
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//割り当てて全要素を検査する
+int Validate(const char* path) {
+	auto start = std::chrono::steady_clock::now();
+	MappedSceneFile scene;
+	SceneFileResult result = scene.Open(path);
+	if (result != SceneFileResult::kOk) {
+		std::fprintf(stderr, "%s: %s\n", path, GetSceneFileResultName(result));
+		return 1;
+	}
+	double openMs = MillisecondsSince(start);
+	start = std::chrono::steady_clock::now();
+	size_t badIndex = 0;
+	result = ValidateSceneFile(scene, badIndex);
+	if (result == SceneFileResult::kBadValue) {
+		std::fprintf(stderr, "%s: %s (element %zu)\n", path, GetSceneFileResultName(result), badIndex);
+		return 1;
+	}
+	else if (result != SceneFileResult::kOk) {
+		std::fprintf(stderr, "%s: %s\n", path, GetSceneFileResultName(result));
+		return 1;
+	}
+	std::printf("%s: %llu obbs, %llu segments, %zu bytes (open %.3f ms, validate %.3f ms)\n", path,
+		(unsigned long long)scene.GetHeader().obbCount, (unsigned long long)scene.GetHeader().segmentCount, scene.GetSize(),
+		openMs, MillisecondsSince(start));
+	return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+	const char* usage =
+		"usage: MT2SceneConvert <input.txt> <output.mt2scene>\n"
+		"       MT2SceneConvert --random=OBBS,SEGMENTS [--seed=N] <output.mt2scene>\n"
+		"       MT2SceneConvert --validate <scene.mt2scene>\n";
+	if (argc == 3 && std::strcmp(argv[1], "--validate") == 0) {
+		return Validate(argv[2]);
+	}
+
+	OBBSoA obbs;
+	SegmentSoA segments;
+	const char* output = nullptr;
+	if (argc >= 3 && std::strncmp(argv[1], "--random=", 9) == 0) {
+		char* end = nullptr;
+		size_t obbCount = size_t(std::strtoull(argv[1] + 9, &end, 10));
+		if (*end != ',') {
+			std::fprintf(stderr, "%s", usage);
+			return 1;
+		}
+		size_t segmentCount = size_t(std::strtoull(end + 1, nullptr, 10));
+		uint32_t seed = 12345;
+		if (argc == 4 && std::strncmp(argv[2], "--seed=", 7) == 0) {
+			seed = uint32_t(std::strtoul(argv[2] + 7, nullptr, 10));
+		}
+		else if (argc != 3) {
+			std::fprintf(stderr, "%s", usage);
+			return 1;
+		}
+		MakeRandomScene(obbCount, segmentCount, seed, obbs, segments);
+		output = argv[argc - 1];
+	}
+	else if (argc == 3) {
+		size_t errorLine = 0;
+		SceneFileResult result = LoadSceneText(argv[1], obbs, segments, errorLine);
+		if (result != SceneFileResult::kOk) {
+			std::fprintf(stderr, "%s:%zu: %s\n", argv[1], errorLine, GetSceneFileResultName(result));
+			return 1;
+		}
+		output = argv[2];
+	}
+	else {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+
+	SceneFileResult result = WriteSceneFile(output, obbs.View(), segments.View());
+	if (result != SceneFileResult::kOk) {
+		std::fprintf(stderr, "%s: %s\n", output, GetSceneFileResultName(result));
+		return 1;
+	}
+	//書いたものを読み直して確かめる
+	return Validate(output);
+}